@@ -0,0 +1,213 @@
+/*
+ * Parallel Boruvka
+ *
+ * Minimum spanning forest in rounds. Each round
+ *
+ *  1. scans the live edges in parallel and records, per component, the
+ *     cheapest edge leaving it with an atomic compare-and-swap minimum,
+ *  2. picks every component's cheapest edge for the forest (an edge picked
+ *     by both of its components is only taken once),
+ *  3. contracts all of them at once by unioning in a ConcurrentDisjointSet,
+ *  4. compacts the edge list down to edges whose endpoints are still in
+ *     different components.
+ *
+ * Edges are ordered by (weight, position in the edge list), so ties can't
+ * close a cycle and the forest has the same weight as Prim::mst. Every
+ * round at least halves the number of components.
+ */
+
+#ifndef Boruvka_Included
+#define Boruvka_Included
+
+#include "UndirectedGraph.hh"
+#include "CSRGraph.hh"
+#include "InternedGraph.hh"
+#include "ConcurrentDisjointSet.hh"
+#include "Parallel.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+template <typename T>
+class Boruvka {
+  public:
+    // numThreads of 0 uses every hardware thread
+    static UndirectedGraph<T> mst(const UndirectedGraph<T>& graph,
+                                  size_t numThreads = 0);
+    static std::vector<CSRGraph::Edge> mst(const CSRGraph& graph,
+                                           size_t numThreads = 0);
+    static std::vector<CSRGraph::Edge> mst(size_t numVertices,
+        const std::vector<CSRGraph::Edge>& edges, size_t numThreads = 0);
+
+  private:
+    static constexpr size_t NONE = SIZE_MAX;
+
+    static inline bool lighter(const std::vector<CSRGraph::Edge>& edges,
+                               size_t one, size_t two);
+    static inline void offerEdge(std::atomic<size_t>& cheapest, size_t edge,
+                                 const std::vector<CSRGraph::Edge>& edges);
+    static void concatenate(std::vector<std::vector<size_t>>& parts,
+                            std::vector<size_t>& result, size_t numThreads);
+};
+
+template <typename T>
+UndirectedGraph<T> Boruvka<T>::mst(const UndirectedGraph<T>& graph,
+                                   size_t numThreads) {
+  InternedGraph<T> interned(graph);
+  return interned.translate(mst(interned.getGraph(), numThreads));
+}
+
+template <typename T>
+std::vector<CSRGraph::Edge> Boruvka<T>::mst(const CSRGraph& graph,
+                                            size_t numThreads) {
+  return mst(graph.size(), graph.edgeList(), numThreads);
+}
+
+template <typename T>
+inline bool Boruvka<T>::lighter(const std::vector<CSRGraph::Edge>& edges,
+                                size_t one, size_t two) {
+  return edges[one].weight < edges[two].weight ||
+    (edges[one].weight == edges[two].weight && one < two);
+}
+
+// lowers cheapest to edge if edge is lighter than what it holds
+template <typename T>
+inline void Boruvka<T>::offerEdge(std::atomic<size_t>& cheapest, size_t edge,
+    const std::vector<CSRGraph::Edge>& edges) {
+  size_t current = cheapest.load(std::memory_order_relaxed);
+  while (current == NONE || lighter(edges, edge, current)) {
+    if (cheapest.compare_exchange_weak(current, edge,
+                                       std::memory_order_relaxed)) {
+      return;
+    }
+  }
+}
+
+// gathers the per-thread parts, in thread order, into result
+template <typename T>
+void Boruvka<T>::concatenate(std::vector<std::vector<size_t>>& parts,
+                             std::vector<size_t>& result, size_t numThreads) {
+  std::vector<size_t> starts(parts.size() + 1, 0);
+  for (size_t t = 0; t < parts.size(); ++t) {
+    starts[t + 1] = starts[t] + parts[t].size();
+  }
+  result.resize(starts.back());
+  Parallel::forChunks(parts.size(), numThreads,
+    [&](size_t begin, size_t end, size_t) {
+      for (size_t t = begin; t < end; ++t) {
+        std::copy(parts[t].begin(), parts[t].end(), result.begin() + starts[t]);
+        parts[t].clear();
+      }
+    }, 1);
+}
+
+template <typename T>
+std::vector<CSRGraph::Edge> Boruvka<T>::mst(size_t numVertices,
+    const std::vector<CSRGraph::Edge>& edges, size_t numThreads) {
+  numThreads = Parallel::numThreads(numThreads);
+  std::vector<CSRGraph::Edge> result;
+  ConcurrentDisjointSet components(numVertices);
+  std::unique_ptr<std::atomic<size_t>[]> cheapest(
+      new std::atomic<size_t>[numVertices]);
+  std::vector<std::vector<size_t>> parts(numThreads);
+
+  // live edge indices and the component roots that still have edges
+  std::vector<size_t> live;
+  std::vector<size_t> roots;
+  Parallel::forChunks(edges.size(), numThreads,
+    [&](size_t begin, size_t end, size_t thread) {
+      for (size_t e = begin; e < end; ++e) {
+        if (edges[e].first != edges[e].second) parts[thread].push_back(e);
+      }
+    });
+  concatenate(parts, live, numThreads);
+  Parallel::forChunks(numVertices, numThreads,
+    [&](size_t begin, size_t end, size_t thread) {
+      for (size_t v = begin; v < end; ++v) {
+        cheapest[v].store(NONE, std::memory_order_relaxed);
+        parts[thread].push_back(v);
+      }
+    });
+  concatenate(parts, roots, numThreads);
+
+  std::vector<size_t> picked;
+  while (!live.empty()) {
+    // cheapest edge out of every component
+    Parallel::forChunks(live.size(), numThreads,
+      [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+          size_t e = live[i];
+          uint32_t one = components.find(edges[e].first);
+          uint32_t two = components.find(edges[e].second);
+          if (one == two) continue;
+          offerEdge(cheapest[one], e, edges);
+          offerEdge(cheapest[two], e, edges);
+        }
+      });
+
+    // an edge that is the cheapest for both of its components is kept by
+    // the lower root only; nothing is unioned yet so the finds are stable
+    Parallel::forChunks(roots.size(), numThreads,
+      [&](size_t begin, size_t end, size_t thread) {
+        for (size_t i = begin; i < end; ++i) {
+          uint32_t root = roots[i];
+          size_t e = cheapest[root].load(std::memory_order_relaxed);
+          if (e == NONE) continue;
+          uint32_t other = components.find(edges[e].first);
+          if (other == root) other = components.find(edges[e].second);
+          if (other < root &&
+              cheapest[other].load(std::memory_order_relaxed) == e) continue;
+          parts[thread].push_back(e);
+        }
+      });
+    concatenate(parts, picked, numThreads);
+
+    // contract every picked edge in one bulk step
+    Parallel::forChunks(picked.size(), numThreads,
+      [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+          components.unionSets(edges[picked[i]].first,
+                               edges[picked[i]].second);
+        }
+      });
+    for (size_t e : picked) {
+      result.push_back(edges[e]);
+    }
+
+    // components without an outgoing edge are finished, merged ones are no
+    // longer roots
+    Parallel::forChunks(roots.size(), numThreads,
+      [&](size_t begin, size_t end, size_t thread) {
+        for (size_t i = begin; i < end; ++i) {
+          uint32_t root = roots[i];
+          bool hadEdge = cheapest[root].load(std::memory_order_relaxed) != NONE;
+          cheapest[root].store(NONE, std::memory_order_relaxed);
+          if (hadEdge && components.find(root) == root) {
+            parts[thread].push_back(root);
+          }
+        }
+      });
+    concatenate(parts, roots, numThreads);
+
+    // drop the edges that became internal to a component
+    Parallel::forChunks(live.size(), numThreads,
+      [&](size_t begin, size_t end, size_t thread) {
+        for (size_t i = begin; i < end; ++i) {
+          size_t e = live[i];
+          if (components.find(edges[e].first) !=
+              components.find(edges[e].second)) {
+            parts[thread].push_back(e);
+          }
+        }
+      });
+    concatenate(parts, live, numThreads);
+  }
+
+  return result;
+}
+
+#endif
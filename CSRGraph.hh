@@ -0,0 +1,221 @@
+/*
+ * Compressed Sparse Row Graph
+ *
+ * A static undirected graph over the dense vertex ids [0, size()). The
+ * neighbors of vertex v live contiguously in mNeighbors between
+ * mOffsets[v] and mOffsets[v + 1], with the matching weights at the same
+ * positions in mWeights. Every edge is stored once in each direction.
+ *
+ * Unlike UndirectedGraph there is no per-vertex hash table, so a graph
+ * with m edges costs (n + 1) offsets plus 2m neighbor/weight pairs and
+ * walking edgesFrom() is a linear scan over two arrays.
+ */
+
+#ifndef CSRGraph_Included
+#define CSRGraph_Included
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class CSRGraph {
+  public:
+    struct Edge {
+      uint32_t first;
+      uint32_t second;
+      double weight;
+    };
+
+    // iterates the (neighbor, weight) pairs of a single vertex, in the same
+    // shape as the map entries UndirectedGraph::edgesFrom hands out
+    class const_iterator {
+      public:
+        const_iterator(const uint32_t *neighbor, const double *weight);
+
+        inline std::pair<uint32_t, double> operator*() const;
+        inline const_iterator& operator++();
+        inline bool operator==(const const_iterator& other) const;
+        inline bool operator!=(const const_iterator& other) const;
+
+      private:
+        const uint32_t *mNeighbor;
+        const double *mWeight;
+    };
+
+    class EdgeRange {
+      public:
+        EdgeRange(const_iterator begin, const_iterator end);
+
+        inline const_iterator begin() const;
+        inline const_iterator end() const;
+
+      private:
+        const_iterator mBegin;
+        const_iterator mEnd;
+    };
+
+    CSRGraph();
+    // self loops are dropped, parallel edges are kept
+    CSRGraph(size_t numVertices, const std::vector<Edge>& edges);
+    ~CSRGraph();
+
+    inline size_t size() const;
+    inline size_t numEdges() const;
+    inline bool isEmpty() const;
+
+    inline size_t degree(uint32_t vertex) const;
+    inline EdgeRange edgesFrom(uint32_t vertex) const;
+
+    // raw access for inner loops: the neighbors of v are the slots
+    // [offset(v), offset(v + 1))
+    inline size_t offset(uint32_t vertex) const;
+    inline uint32_t neighbor(size_t slot) const;
+    inline double weight(size_t slot) const;
+
+    // every edge once, as (lower id, higher id, weight)
+    std::vector<Edge> edgeList() const;
+
+    // bytes held by the offset, neighbor and weight arrays
+    inline size_t memoryUsage() const;
+
+  private:
+    std::vector<size_t> mOffsets;
+    std::vector<uint32_t> mNeighbors;
+    std::vector<double> mWeights;
+};
+
+inline CSRGraph::const_iterator::const_iterator(const uint32_t *neighbor,
+    const double *weight) : mNeighbor(neighbor), mWeight(weight) {
+  // Handled in initializer list.
+}
+
+inline std::pair<uint32_t, double>
+CSRGraph::const_iterator::operator*() const {
+  return std::make_pair(*mNeighbor, *mWeight);
+}
+
+inline CSRGraph::const_iterator& CSRGraph::const_iterator::operator++() {
+  ++mNeighbor;
+  ++mWeight;
+  return *this;
+}
+
+inline bool CSRGraph::const_iterator::operator==(
+    const const_iterator& other) const {
+  return mNeighbor == other.mNeighbor;
+}
+
+inline bool CSRGraph::const_iterator::operator!=(
+    const const_iterator& other) const {
+  return mNeighbor != other.mNeighbor;
+}
+
+inline CSRGraph::EdgeRange::EdgeRange(const_iterator begin,
+    const_iterator end) : mBegin(begin), mEnd(end) {
+  // Handled in initializer list.
+}
+
+inline CSRGraph::const_iterator CSRGraph::EdgeRange::begin() const {
+  return mBegin;
+}
+
+inline CSRGraph::const_iterator CSRGraph::EdgeRange::end() const {
+  return mEnd;
+}
+
+inline CSRGraph::CSRGraph() : mOffsets(1, 0) {
+  // Handled in initializer list.
+}
+
+inline CSRGraph::CSRGraph(size_t numVertices, const std::vector<Edge>& edges)
+  : mOffsets(numVertices + 1, 0) {
+  // count the degree of every vertex, shifted by one so that the prefix sum
+  // below turns the counts into starting offsets
+  for (const Edge& edge : edges) {
+    if (edge.first == edge.second) continue;
+    mOffsets[edge.first + 1]++;
+    mOffsets[edge.second + 1]++;
+  }
+  for (size_t v = 0; v < numVertices; ++v) {
+    mOffsets[v + 1] += mOffsets[v];
+  }
+
+  mNeighbors.resize(mOffsets[numVertices]);
+  mWeights.resize(mOffsets[numVertices]);
+
+  // scatter both directions of every edge, using a moving cursor per vertex
+  std::vector<size_t> cursor(mOffsets.begin(), mOffsets.end() - 1);
+  for (const Edge& edge : edges) {
+    if (edge.first == edge.second) continue;
+    size_t slot = cursor[edge.first]++;
+    mNeighbors[slot] = edge.second;
+    mWeights[slot] = edge.weight;
+    slot = cursor[edge.second]++;
+    mNeighbors[slot] = edge.first;
+    mWeights[slot] = edge.weight;
+  }
+}
+
+inline CSRGraph::~CSRGraph() {
+  // Does nothing.
+}
+
+inline size_t CSRGraph::size() const {
+  return mOffsets.size() - 1;
+}
+
+inline size_t CSRGraph::numEdges() const {
+  return mNeighbors.size() / 2;
+}
+
+inline bool CSRGraph::isEmpty() const {
+  return size() == 0;
+}
+
+inline size_t CSRGraph::degree(uint32_t vertex) const {
+  return mOffsets[vertex + 1] - mOffsets[vertex];
+}
+
+inline CSRGraph::EdgeRange CSRGraph::edgesFrom(uint32_t vertex) const {
+  size_t begin = mOffsets[vertex];
+  size_t end = mOffsets[vertex + 1];
+  return EdgeRange(const_iterator(mNeighbors.data() + begin,
+                                  mWeights.data() + begin),
+                   const_iterator(mNeighbors.data() + end,
+                                  mWeights.data() + end));
+}
+
+inline size_t CSRGraph::offset(uint32_t vertex) const {
+  return mOffsets[vertex];
+}
+
+inline uint32_t CSRGraph::neighbor(size_t slot) const {
+  return mNeighbors[slot];
+}
+
+inline double CSRGraph::weight(size_t slot) const {
+  return mWeights[slot];
+}
+
+inline std::vector<CSRGraph::Edge> CSRGraph::edgeList() const {
+  std::vector<Edge> edges;
+  edges.reserve(numEdges());
+  for (uint32_t v = 0; v < size(); ++v) {
+    for (size_t slot = mOffsets[v]; slot < mOffsets[v + 1]; ++slot) {
+      if (v < mNeighbors[slot]) {
+        Edge edge = { v, mNeighbors[slot], mWeights[slot] };
+        edges.push_back(edge);
+      }
+    }
+  }
+  return edges;
+}
+
+inline size_t CSRGraph::memoryUsage() const {
+  return mOffsets.capacity() * sizeof(size_t) +
+    mNeighbors.capacity() * sizeof(uint32_t) +
+    mWeights.capacity() * sizeof(double);
+}
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * Compares the CSRGraph backend against the UndirectedGraph map-of-maps on
+ * the same random edge list: bytes held by each representation, the time
+ * for a full edgesFrom() sweep over every vertex, and Prim::mst.
+ *
+ * usage: CSRGraphBench [vertices] [edges]
+ */
+
+#include "CSRGraph.hh"
+#include "UndirectedGraph.hh"
+#include "Prim.hh"
+
+#include <malloc.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+static size_t heapInUse() {
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+}
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 1000000;
+  size_t m = argc > 2 ? std::strtoull(argv[2], NULL, 10) : 8 * n;
+
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> weight(0.0, 1.0);
+  std::vector<CSRGraph::Edge> edges;
+  edges.reserve(m);
+  for (size_t i = 1; i < n && edges.size() < m; i++) {
+    CSRGraph::Edge edge = { (uint32_t) (rng() % i), (uint32_t) i, weight(rng) };
+    edges.push_back(edge);
+  }
+  while (edges.size() < m) {
+    CSRGraph::Edge edge = { (uint32_t) (rng() % n), (uint32_t) (rng() % n),
+      weight(rng) };
+    edges.push_back(edge);
+  }
+  std::cout << "vertices " << n << ", edges " << m << std::endl;
+
+  size_t before = heapInUse();
+  auto start = std::chrono::steady_clock::now();
+  UndirectedGraph<uint32_t> *mapGraph = new UndirectedGraph<uint32_t>();
+  for (const CSRGraph::Edge& edge : edges) {
+    mapGraph->addEdge(edge.first, edge.second, edge.weight);
+  }
+  double mapBuild = secondsSince(start);
+  size_t mapBytes = heapInUse() - before;
+
+  before = heapInUse();
+  start = std::chrono::steady_clock::now();
+  CSRGraph *csr = new CSRGraph(n, edges);
+  double csrBuild = secondsSince(start);
+  size_t csrBytes = heapInUse() - before;
+
+  start = std::chrono::steady_clock::now();
+  double mapSum = 0;
+  for (uint32_t v = 0; v < n; v++) {
+    for (const auto& edge : mapGraph->edgesFrom(v)) mapSum += edge.second;
+  }
+  double mapSweep = secondsSince(start);
+
+  start = std::chrono::steady_clock::now();
+  double csrSum = 0;
+  for (uint32_t v = 0; v < n; v++) {
+    for (const auto& edge : csr->edgesFrom(v)) csrSum += edge.second;
+  }
+  double csrSweep = secondsSince(start);
+
+  start = std::chrono::steady_clock::now();
+  UndirectedGraph<uint32_t> mapTree = Prim<uint32_t>::mst(*mapGraph);
+  double mapPrim = secondsSince(start);
+
+  start = std::chrono::steady_clock::now();
+  std::vector<CSRGraph::Edge> csrTree = Prim<uint32_t>::mst(*csr);
+  double csrPrim = secondsSince(start);
+
+  std::cout << "             bytes        build(s)   sweep(s)   prim(s)"
+            << std::endl;
+  std::cout << "map-of-maps  " << mapBytes << "  " << mapBuild << "  "
+            << mapSweep << "  " << mapPrim << std::endl;
+  std::cout << "csr          " << csrBytes << "  " << csrBuild << "  "
+            << csrSweep << "  " << csrPrim << std::endl;
+  std::cout << "csr reports  " << csr->memoryUsage() << " bytes" << std::endl;
+  std::cout << "checksums    " << mapSum << " " << csrSum << " "
+            << mapTree.size() << " " << csrTree.size() + 1 << std::endl;
+
+  delete mapGraph;
+  delete csr;
+  return 0;
+}
@@ -0,0 +1,153 @@
+/*
+ * Chazelle
+ *
+ * Minimum spanning forest built on the soft heap, after Chazelle's
+ * algorithm. Each call
+ *
+ *  1. runs a Boruvka step on a FlatDisjointSetForest, which at least
+ *     halves the vertex count and drops parallel edges,
+ *  2. partitions the contracted graph into subgraphs by growing each one
+ *     Prim-style out of a SoftHeap, until it has target vertices or its
+ *     lightest boundary edge reaches an earlier subgraph, which it then
+ *     fuses with,
+ *  3. recursively computes the minimum spanning forest T' of the graph
+ *     with every subgraph contracted and every bad edge left out,
+ *  4. finishes with Kruskal on the grown tree edges, T' and the bad edges.
+ *
+ * An edge is bad if the soft heap ever corrupted it. Raising every bad
+ * edge to infinity gives a graph G* in which each extraction of a good
+ * edge was an honest Prim step, so the subgraphs are contractible in G*
+ * and their tree edges plus T' are MST(G*). Since MST(G) is a subset of
+ * MST(G*) plus the bad edges, step 4 finds it.
+ *
+ * This keeps Chazelle's contractible subgraphs, soft heap growth and
+ * corruption tracking, but not his O(m alpha(m, n)) bound. It builds one
+ * level of subgraphs per call rather than his hierarchy of Ackermann-sized
+ * targets, and the Kruskal of step 4 sorts, so it runs in O(m log n) and
+ * is slower than Prim in practice. The soft heap error rate epsilon bounds
+ * the bad edges, target is picked so a subgraph's heap stays around 2^r
+ * elements.
+ */
+
+#ifndef Chazelle_Included
+#define Chazelle_Included
+
+#include "UndirectedGraph.hh"
+#include "CSRGraph.hh"
+#include "InternedGraph.hh"
+#include "FlatDisjointSet.hh"
+#include "FlatDisjointSetForest.hh"
+#include "SoftHeapPartition.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Heap is the soft heap policy SoftHeapPartition grows the subgraphs with
+template <typename T, typename Heap = SoftHeap<size_t> >
+class Chazelle {
+  public:
+    // epsilon is the error rate of the soft heaps
+    static UndirectedGraph<T> mst(const UndirectedGraph<T>& graph,
+                                  double epsilon = 0.125);
+    static std::vector<CSRGraph::Edge> mst(const CSRGraph& graph,
+                                           double epsilon = 0.125);
+    static std::vector<CSRGraph::Edge> mst(size_t numVertices,
+        const std::vector<CSRGraph::Edge>& edges, double epsilon = 0.125);
+
+  private:
+    typedef SoftHeapPartition<Heap> Partition;
+    typedef typename Partition::Edge Edge;
+
+    // appends the minimum spanning forest of edges to result; only the
+    // origins of the appended edges are meaningful to the caller, position
+    // is scratch space indexed by origin
+    static void msf(size_t numVertices, const std::vector<Edge>& edges,
+                    std::vector<Edge>& result, std::vector<size_t>& position,
+                    size_t r);
+};
+
+template <typename T, typename Heap>
+UndirectedGraph<T> Chazelle<T, Heap>::mst(const UndirectedGraph<T>& graph,
+                                          double epsilon) {
+  InternedGraph<T> interned(graph);
+  return interned.translate(mst(interned.getGraph(), epsilon));
+}
+
+template <typename T, typename Heap>
+std::vector<CSRGraph::Edge> Chazelle<T, Heap>::mst(const CSRGraph& graph,
+                                                   double epsilon) {
+  return mst(graph.size(), graph.edgeList(), epsilon);
+}
+
+template <typename T, typename Heap>
+std::vector<CSRGraph::Edge> Chazelle<T, Heap>::mst(size_t numVertices,
+    const std::vector<CSRGraph::Edge>& edges, double epsilon) {
+  std::vector<Edge> forest;
+  std::vector<size_t> position(edges.size());
+  msf(numVertices, Partition::tag(edges), forest, position,
+      Heap::rForEpsilon(epsilon));
+  return Partition::untag(edges, forest);
+}
+
+template <typename T, typename Heap>
+void Chazelle<T, Heap>::msf(size_t numVertices,
+                            const std::vector<Edge>& edges,
+                            std::vector<Edge>& result,
+                            std::vector<size_t>& position, size_t r) {
+  const size_t baseCase = 1024;
+  if (edges.size() <= baseCase) {
+    Partition::kruskal(numVertices, edges, result);
+    return;
+  }
+
+  FlatDisjointSetForest forest(numVertices, edges);
+  forest.boruvkaStep(result);
+  if (forest.numEdges() == 0) return;
+
+  const std::vector<Edge>& level = forest.getEdges();
+  size_t size = forest.size();
+  size_t degree = (2 * level.size() + size - 1) / size;
+  size_t target = std::max<size_t>(2, ((size_t) 1 << r) / degree);
+
+  Partition partition(size, level, r);
+  const std::vector<uint32_t>& subgraph = partition.getSubgraphs();
+  const std::vector<uint8_t>& state = partition.getStates();
+  // subgraphs fused with the earlier ones they reached, by subgraph number
+  FlatDisjointSet fused(size);
+  for (uint32_t source = 0; source < size; ++source) {
+    if (subgraph[source] != Partition::NONE) continue;
+    uint32_t reached = partition.grow(source, target);
+    if (reached != Partition::NONE) {
+      fused.unionSets(subgraph[source], subgraph[reached]);
+    }
+  }
+
+  // contract every fused subgraph, numbering them densely; the grown and
+  // bad edges go straight to the final Kruskal
+  std::vector<uint32_t> label(partition.numSubgraphs());
+  uint32_t numContracted = 0;
+  for (size_t s = 0; s < partition.numSubgraphs(); ++s) {
+    if (fused.find(s) == s) label[s] = numContracted++;
+  }
+  std::vector<Edge> candidates;
+  std::vector<Edge> contracted;
+  for (size_t i = 0; i < level.size(); ++i) {
+    if (state[i] != Partition::UNSEEN) {
+      candidates.push_back(level[i]);
+      continue;
+    }
+    Edge edge = level[i];
+    edge.first = label[fused.find(subgraph[edge.first])];
+    edge.second = label[fused.find(subgraph[edge.second])];
+    if (edge.first != edge.second) contracted.push_back(edge);
+  }
+
+  std::vector<Edge> between;
+  msf(numContracted, contracted, between, position, r);
+  Partition::lookUp(level, between, candidates, position);
+  Partition::kruskal(size, candidates, result);
+}
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * Times Chazelle::mst against Prim::mst and a single threaded
+ * Boruvka::mst on random connected graphs with a fixed vertex count and a
+ * growing edge density m/n.
+ *
+ * usage: ChazelleBench [vertices] [maxDensity] [epsilon]
+ */
+
+#include "CSRGraph.hh"
+#include "Prim.hh"
+#include "Boruvka.hh"
+#include "Chazelle.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+static double totalWeight(const std::vector<CSRGraph::Edge>& edges) {
+  double total = 0;
+  for (const CSRGraph::Edge& edge : edges) total += edge.weight;
+  return total;
+}
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 100000;
+  size_t maxDensity = argc > 2 ? std::strtoull(argv[2], NULL, 10) : 64;
+  double epsilon = argc > 3 ? std::strtod(argv[3], NULL) : 0.125;
+
+  std::cout << "vertices " << n << ", epsilon " << epsilon << std::endl;
+  std::cout << "m/n   prim(s)     boruvka(s)  chazelle(s)" << std::endl;
+  for (size_t density = 2; density <= maxDensity; density *= 2) {
+    std::mt19937_64 rng(density);
+    std::uniform_real_distribution<double> weight(0.0, 1.0);
+    std::vector<CSRGraph::Edge> edges;
+    edges.reserve(density * n);
+    for (size_t i = 1; i < n; i++) {
+      CSRGraph::Edge edge = { (uint32_t) (rng() % i), (uint32_t) i, weight(rng) };
+      edges.push_back(edge);
+    }
+    while (edges.size() < density * n) {
+      CSRGraph::Edge edge = { (uint32_t) (rng() % n), (uint32_t) (rng() % n),
+        weight(rng) };
+      edges.push_back(edge);
+    }
+    CSRGraph graph(n, edges);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<CSRGraph::Edge> primTree = Prim<uint32_t>::mst(graph);
+    double primTime = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<CSRGraph::Edge> boruvkaTree =
+      Boruvka<uint32_t>::mst(n, edges, 1);
+    double boruvkaTime = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<CSRGraph::Edge> chazelleTree =
+      Chazelle<uint32_t>::mst(n, edges, epsilon);
+    double chazelleTime = secondsSince(start);
+
+    // the sums add the same weights in a different order
+    if (std::abs(totalWeight(primTree) - totalWeight(chazelleTree)) > 1e-6 ||
+        std::abs(totalWeight(primTree) - totalWeight(boruvkaTree)) > 1e-6) {
+      std::cout << "tree weights differ" << std::endl;
+      return 1;
+    }
+    std::cout << density << "     " << primTime << "    " << boruvkaTime
+              << "    " << chazelleTime << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * Concurrent Disjoint Set
+ *
+ * Lock-free union-find over the dense ids [0, size()) that any number of
+ * threads may find and union on at the same time. It follows Jayanti and
+ * Tarjan's randomized concurrent union-find: every link and every path
+ * compaction step is a single compare-and-swap on the shared parent
+ * array, and there is no rank or size word that would need to be updated
+ * together with the parent.
+ *
+ *  - find does path halving with CAS. A failed CAS only means another
+ *    thread already shortened that link, so it is never retried.
+ *  - unionSets links by a fixed random priority per element instead of by
+ *    rank: the root with the lower priority is CAS'd under the other. If
+ *    the CAS fails the root was linked concurrently and we retry from the
+ *    two finds. The priorities come from a bijective hash of the id, so
+ *    they are distinct and cost no memory.
+ */
+
+#ifndef ConcurrentDisjointSet_Included
+#define ConcurrentDisjointSet_Included
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class ConcurrentDisjointSet {
+  public:
+    ConcurrentDisjointSet(size_t size);
+    ~ConcurrentDisjointSet();
+
+    inline size_t size() const;
+
+    inline uint32_t find(uint32_t id);
+    // returns true if this call merged two different sets
+    inline bool unionSets(uint32_t one, uint32_t two);
+    inline bool sameSet(uint32_t one, uint32_t two);
+
+    // not thread safe, call only while no other thread is using the sets
+    void reset();
+
+  private:
+    std::unique_ptr<std::atomic<uint32_t>[]> mParent;
+    size_t mSize;
+
+    static inline uint32_t priority(uint32_t id);
+
+    ConcurrentDisjointSet(ConcurrentDisjointSet const &) = delete;
+    void operator=(ConcurrentDisjointSet const &) = delete;
+};
+
+inline ConcurrentDisjointSet::ConcurrentDisjointSet(size_t size) :
+  mParent(new std::atomic<uint32_t>[size]), mSize(size) {
+  reset();
+}
+
+inline ConcurrentDisjointSet::~ConcurrentDisjointSet() {
+  // Does nothing.
+}
+
+inline size_t ConcurrentDisjointSet::size() const {
+  return mSize;
+}
+
+// murmur3's 32 bit finalizer, a bijection on uint32_t
+inline uint32_t ConcurrentDisjointSet::priority(uint32_t id) {
+  id ^= id >> 16;
+  id *= 0x85EBCA6Bu;
+  id ^= id >> 13;
+  id *= 0xC2B2AE35u;
+  id ^= id >> 16;
+  return id;
+}
+
+inline uint32_t ConcurrentDisjointSet::find(uint32_t id) {
+  for (;;) {
+    uint32_t parent = mParent[id].load(std::memory_order_acquire);
+    if (parent == id) return id;
+    uint32_t grandparent = mParent[parent].load(std::memory_order_acquire);
+    if (grandparent == parent) return parent;
+    mParent[id].compare_exchange_weak(parent, grandparent,
+                                      std::memory_order_acq_rel,
+                                      std::memory_order_relaxed);
+    id = grandparent;
+  }
+}
+
+inline bool ConcurrentDisjointSet::unionSets(uint32_t one, uint32_t two) {
+  for (;;) {
+    one = find(one);
+    two = find(two);
+    if (one == two) return false;
+    if (priority(one) > priority(two)) {
+      uint32_t tmp = one;
+      one = two;
+      two = tmp;
+    }
+    uint32_t expected = one;
+    if (mParent[one].compare_exchange_strong(expected, two,
+                                             std::memory_order_acq_rel)) {
+      return true;
+    }
+  }
+}
+
+// a root seen by find may be linked away before we compare, so only
+// report different sets once the first one is still a root afterwards
+inline bool ConcurrentDisjointSet::sameSet(uint32_t one, uint32_t two) {
+  for (;;) {
+    one = find(one);
+    two = find(two);
+    if (one == two) return true;
+    if (mParent[one].load(std::memory_order_acquire) == one) return false;
+  }
+}
+
+inline void ConcurrentDisjointSet::reset() {
+  for (size_t i = 0; i < mSize; ++i) {
+    mParent[i].store(i, std::memory_order_relaxed);
+  }
+}
+
+#endif
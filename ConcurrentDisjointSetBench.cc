@@ -0,0 +1,93 @@
+/*
+ * Scaling benchmark for ConcurrentDisjointSet: every thread count from 1 to
+ * the given maximum unions the same edge list, split into contiguous
+ * slices, on a uniform random edge set and on a power-law one where the
+ * endpoints concentrate on a few hub vertices. The serial FlatDisjointSet
+ * is timed as the baseline.
+ *
+ * usage: ConcurrentDisjointSetBench [vertices] [edges] [maxThreads]
+ */
+
+#include "FlatDisjointSet.hh"
+#include "ConcurrentDisjointSet.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+// endpoints drawn log-uniformly over [1, n], i.e. with density ~ 1/x, so
+// low ids are hubs, then scattered over the id space with a multiply
+static std::vector<uint32_t> endpoints(size_t n, size_t m, bool powerLaw,
+    unsigned seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::vector<uint32_t> result(2 * m);
+  for (size_t i = 0; i < 2 * m; i++) {
+    if (powerLaw) {
+      uint64_t x = (uint64_t) std::pow((double) n, unit(rng)) - 1;
+      result[i] = (x * 2654435761ull) % n;
+    } else {
+      result[i] = rng() % n;
+    }
+  }
+  return result;
+}
+
+static void run(const char *name, size_t n, size_t m, size_t maxThreads,
+    const std::vector<uint32_t>& ends) {
+  auto start = std::chrono::steady_clock::now();
+  FlatDisjointSet serial(n);
+  for (size_t i = 0; i < m; i++) serial.unionSets(ends[2 * i], ends[2 * i + 1]);
+  double serialTime = secondsSince(start);
+  std::cout << name << "  serial flat  " << serialTime << "s, "
+            << serial.numSets() << " sets" << std::endl;
+
+  for (size_t numThreads = 1; numThreads <= maxThreads; numThreads++) {
+    ConcurrentDisjointSet sets(n);
+    std::vector<std::thread> threads;
+    std::vector<size_t> merges(numThreads, 0);
+    start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < numThreads; t++) {
+      threads.push_back(std::thread([&, t]() {
+        size_t begin = m * t / numThreads;
+        size_t end = m * (t + 1) / numThreads;
+        size_t merged = 0;
+        for (size_t i = begin; i < end; i++) {
+          if (sets.unionSets(ends[2 * i], ends[2 * i + 1])) merged++;
+        }
+        merges[t] = merged;
+      }));
+    }
+    for (std::thread& thread : threads) thread.join();
+    double elapsed = secondsSince(start);
+
+    size_t numSets = n;
+    for (size_t merged : merges) numSets -= merged;
+    std::cout << name << "  threads " << numThreads << "  " << elapsed
+              << "s  speedup " << serialTime / elapsed << "  "
+              << numSets << " sets" << std::endl;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 10000000;
+  size_t m = argc > 2 ? std::strtoull(argv[2], NULL, 10) : 4 * n;
+  size_t maxThreads = argc > 3 ? std::strtoull(argv[3], NULL, 10)
+    : std::thread::hardware_concurrency();
+  if (maxThreads == 0) maxThreads = 1;
+
+  std::cout << "vertices " << n << ", edges " << m << std::endl;
+  run("random   ", n, m, maxThreads, endpoints(n, m, false, 1));
+  run("power-law", n, m, maxThreads, endpoints(n, m, true, 2));
+  return 0;
+}
@@ -0,0 +1,135 @@
+/*
+ * Decision Tree
+ *
+ * Minimum spanning forests of graphs on at most four vertices, read out of
+ * a table. The six possible edges of K4 are numbered
+ *
+ *   (0,1) (0,2) (0,3) (1,2) (1,3) (2,3)
+ *
+ * and the answer only depends on the order of their weights, so the table
+ * maps each of the 6! = 720 orders to the edge set Kruskal picks for it.
+ * The table is built by a constexpr function when the header is compiled.
+ * msf insertion sorts the six slots, up to 15 comparisons, and indexes the
+ * table by the Lehmer code of the order. That is a full sort and a lookup
+ * rather than an optimal comparison tree. Absent edges rank after every
+ * present one, which leaves the forest on the present edges.
+ */
+
+#ifndef DecisionTree_Included
+#define DecisionTree_Included
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+class DecisionTree {
+  public:
+    static constexpr size_t MAX_VERTICES = 4;
+    static constexpr size_t NUM_SLOTS = 6;
+
+    // the slot of the edge between two different vertices below MAX_VERTICES
+    static inline size_t slot(size_t first, size_t second);
+    // bit i of the result is set if slot i is in the minimum spanning forest;
+    // bit i of present says whether slot i has an edge, which then has
+    // weights[i], ties broken by lower origins[i]
+    static inline uint8_t msf(const double *weights, const size_t *origins,
+                              uint8_t present);
+
+  private:
+    typedef std::array<uint8_t, 720> Table;
+
+    static constexpr Table build();
+};
+
+constexpr DecisionTree::Table DecisionTree::build() {
+  const size_t ends[NUM_SLOTS][2] =
+    { { 0, 1 }, { 0, 2 }, { 0, 3 }, { 1, 2 }, { 1, 3 }, { 2, 3 } };
+  Table table = { };
+  for (size_t index = 0; index < 720; ++index) {
+    // decode the Lehmer code into the order of the slots, lightest first
+    size_t order[NUM_SLOTS] = { };
+    bool used[NUM_SLOTS] = { };
+    size_t code = index;
+    size_t radix = 120;
+    for (size_t i = 0; i < NUM_SLOTS; ++i) {
+      size_t digit = code / radix;
+      code %= radix;
+      if (i + 1 < NUM_SLOTS) radix /= NUM_SLOTS - 1 - i;
+      for (size_t s = 0; s < NUM_SLOTS; ++s) {
+        if (used[s]) continue;
+        if (digit-- == 0) {
+          order[i] = s;
+          used[s] = true;
+          break;
+        }
+      }
+    }
+
+    // Kruskal on K4 with a four element union-find
+    size_t parent[MAX_VERTICES] = { 0, 1, 2, 3 };
+    uint8_t mask = 0;
+    for (size_t i = 0; i < NUM_SLOTS; ++i) {
+      size_t first = ends[order[i]][0];
+      size_t second = ends[order[i]][1];
+      while (parent[first] != first) first = parent[first];
+      while (parent[second] != second) second = parent[second];
+      if (first == second) continue;
+      parent[first] = second;
+      mask |= 1 << order[i];
+    }
+    table[index] = mask;
+  }
+  return table;
+}
+
+inline size_t DecisionTree::slot(size_t first, size_t second) {
+  if (first > second) {
+    size_t tmp = first;
+    first = second;
+    second = tmp;
+  }
+  // slots of vertex 0 start at 0, of vertex 1 at 3, of vertex 2 at 5
+  return first == 0 ? second - 1 : first == 1 ? second + 1 : 5;
+}
+
+inline uint8_t DecisionTree::msf(const double *weights, const size_t *origins,
+                                 uint8_t present) {
+  static constexpr Table table = build();
+
+  // insertion sort of the slots, absent ones last in slot order
+  size_t order[NUM_SLOTS];
+  for (size_t i = 0; i < NUM_SLOTS; ++i) {
+    size_t s = i;
+    size_t j = i;
+    for (; j > 0; --j) {
+      size_t t = order[j - 1];
+      bool sPresent = present >> s & 1;
+      bool tPresent = present >> t & 1;
+      bool before;
+      if (sPresent != tPresent) {
+        before = sPresent;
+      } else if (!sPresent) {
+        before = s < t;
+      } else {
+        before = weights[s] < weights[t] ||
+          (weights[s] == weights[t] && origins[s] < origins[t]);
+      }
+      if (!before) break;
+      order[j] = t;
+    }
+    order[j] = s;
+  }
+
+  // Lehmer code: each digit counts the later slots with a smaller number
+  size_t index = 0;
+  for (size_t i = 0; i < NUM_SLOTS; ++i) {
+    size_t digit = 0;
+    for (size_t j = i + 1; j < NUM_SLOTS; ++j) {
+      if (order[j] < order[i]) digit++;
+    }
+    index = index * (NUM_SLOTS - i) + digit;
+  }
+  return table[index] & present;
+}
+
+#endif
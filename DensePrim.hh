@@ -0,0 +1,245 @@
+/*
+ * Dense Prim
+ *
+ * Prim's algorithm in O(V^2) for complete or nearly complete graphs, given
+ * as a weight matrix or as a function producing blocks of a row. There is
+ * no heap: every fringe vertex's distance to the tree sits in a flat array,
+ * and each step relaxes that array against the newest tree vertex's row and
+ * finds its minimum in the same pass, a block of columns at a time. With
+ * AVX-512 or AVX2 enabled at compile time (-mavx512f, -mavx2 or a -march
+ * that has them) the pass runs eight or four lanes at once; otherwise it is
+ * the scalar loop. Tree vertices are kept out of the pass by a second array
+ * that is +infinity for them and -infinity for the rest, which each weight
+ * is raised to before the comparison, so no lane ever branches on them.
+ *
+ * Weights must not be NaN; a missing edge is +infinity, and the diagonal is
+ * ignored. A disconnected graph gives its minimum spanning forest.
+ */
+
+#ifndef DensePrim_Included
+#define DensePrim_Included
+
+#include "CSRGraph.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+class DensePrim {
+  public:
+    // weights is the n by n matrix in row-major order and must be symmetric;
+    // returns the tree edges, grown from vertex 0
+    static std::vector<CSRGraph::Edge> mst(size_t numVertices,
+                                           const double *weights);
+    static std::vector<CSRGraph::Edge> mst(size_t numVertices,
+        const std::vector<double>& weights);
+    // row(vertex, begin, end, out) writes the weights of the edges from
+    // vertex to begin through end - 1 into out, and is called with blocks of
+    // at most BLOCK columns, so rows never have to be held whole; only
+    // callables take this overload, a plain double * is a matrix
+    template <typename RowFunction, typename = typename std::enable_if<
+      std::is_invocable<RowFunction&, uint32_t, size_t, size_t,
+                        double *>::value>::type>
+    static std::vector<CSRGraph::Edge> mst(size_t numVertices,
+                                           RowFunction row);
+    // the complete graph weighted by distance(first, second), which must be
+    // symmetric; each weight is computed twice and never stored
+    template <typename Distance>
+    static std::vector<CSRGraph::Edge> complete(size_t numVertices,
+                                                Distance distance);
+
+    static constexpr size_t BLOCK = 2048;
+
+  private:
+    // rows(vertex, begin, end, scratch) returns the weights from vertex to
+    // begin through end - 1, in scratch or wherever they already are
+    template <typename RowBlocks>
+    static std::vector<CSRGraph::Edge> grow(size_t numVertices,
+                                            RowBlocks rows);
+    // lowers dist[i] to weights[i] raised to done[i] and makes from the
+    // parent of each lowered entry, for i below count; returns the index of
+    // the smallest dist afterwards and puts its value in min
+    static inline size_t relax(double *dist, const double *done,
+                               uint32_t *parent, const double *weights,
+                               size_t count, uint32_t from, double& min);
+};
+
+inline std::vector<CSRGraph::Edge> DensePrim::mst(size_t numVertices,
+                                                  const double *weights) {
+  return grow(numVertices, [=](uint32_t vertex, size_t begin, size_t,
+                               double *) {
+    return weights + vertex * numVertices + begin;
+  });
+}
+
+inline std::vector<CSRGraph::Edge> DensePrim::mst(size_t numVertices,
+    const std::vector<double>& weights) {
+  return mst(numVertices, weights.data());
+}
+
+template <typename RowFunction, typename>
+std::vector<CSRGraph::Edge> DensePrim::mst(size_t numVertices,
+                                           RowFunction row) {
+  return grow(numVertices, [&](uint32_t vertex, size_t begin, size_t end,
+                               double *scratch) {
+    row(vertex, begin, end, scratch);
+    return (const double *) scratch;
+  });
+}
+
+template <typename Distance>
+std::vector<CSRGraph::Edge> DensePrim::complete(size_t numVertices,
+                                                Distance distance) {
+  return mst(numVertices, [&](uint32_t vertex, size_t begin, size_t end,
+                              double *out) {
+    for (size_t i = begin; i < end; ++i) out[i - begin] = distance(vertex, i);
+  });
+}
+
+template <typename RowBlocks>
+std::vector<CSRGraph::Edge> DensePrim::grow(size_t numVertices,
+                                            RowBlocks rows) {
+  const double INF = std::numeric_limits<double>::infinity();
+  std::vector<CSRGraph::Edge> result;
+  if (numVertices == 0) return result;
+  result.reserve(numVertices - 1);
+
+  std::vector<double> dist(numVertices, INF);
+  std::vector<double> done(numVertices, -INF);
+  std::vector<uint32_t> parent(numVertices, 0);
+  std::vector<double> scratch(BLOCK);
+
+  uint32_t node = 0;
+  size_t nextRoot = 0;
+  for (size_t added = 1;; ++added) {
+    done[node] = INF;
+    dist[node] = INF;
+    if (added == numVertices) break;
+
+    double min = INF;
+    size_t argmin = 0;
+    for (size_t begin = 0; begin < numVertices; begin += BLOCK) {
+      size_t end = begin + BLOCK < numVertices ? begin + BLOCK : numVertices;
+      const double *weights = rows(node, begin, end, scratch.data());
+      double blockMin;
+      size_t i = relax(&dist[begin], &done[begin], &parent[begin], weights,
+                       end - begin, node, blockMin);
+      if (blockMin < min) {
+        min = blockMin;
+        argmin = begin + i;
+      }
+    }
+
+    if (min == INF) {
+      // nothing left is reachable, the next tree starts at the first vertex
+      // outside the forest
+      while (done[nextRoot] == INF) nextRoot++;
+      node = nextRoot;
+      continue;
+    }
+    CSRGraph::Edge edge = { parent[argmin], (uint32_t) argmin, min };
+    result.push_back(edge);
+    node = argmin;
+  }
+  return result;
+}
+
+inline size_t DensePrim::relax(double *dist, const double *done,
+                               uint32_t *parent, const double *weights,
+                               size_t count, uint32_t from, double& min) {
+  const double INF = std::numeric_limits<double>::infinity();
+  size_t i = 0;
+  min = INF;
+  size_t argmin = 0;
+
+#if defined(__AVX512F__)
+  __m512d best = _mm512_set1_pd(INF);
+  __m512d bestIndex = _mm512_setzero_pd();
+  __m512d index = _mm512_setr_pd(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m512d step = _mm512_set1_pd(8);
+  for (; i + 8 <= count; i += 8) {
+    __m512d weight = _mm512_max_pd(_mm512_loadu_pd(weights + i),
+                                   _mm512_loadu_pd(done + i));
+    __m512d d = _mm512_loadu_pd(dist + i);
+    __mmask8 lower = _mm512_cmp_pd_mask(weight, d, _CMP_LT_OQ);
+    if (lower) {
+      d = _mm512_mask_blend_pd(lower, d, weight);
+      _mm512_storeu_pd(dist + i, d);
+      // few entries are ever lowered, so the parents go one at a time
+      for (unsigned bits = lower; bits; bits &= bits - 1) {
+        parent[i + __builtin_ctz(bits)] = from;
+      }
+    }
+    __mmask8 less = _mm512_cmp_pd_mask(d, best, _CMP_LT_OQ);
+    best = _mm512_mask_blend_pd(less, best, d);
+    bestIndex = _mm512_mask_blend_pd(less, bestIndex, index);
+    index = _mm512_add_pd(index, step);
+  }
+  double lanes[8];
+  double laneIndices[8];
+  _mm512_storeu_pd(lanes, best);
+  _mm512_storeu_pd(laneIndices, bestIndex);
+  for (size_t lane = 0; lane < 8; ++lane) {
+    if (lanes[lane] < min) {
+      min = lanes[lane];
+      argmin = laneIndices[lane];
+    }
+  }
+#elif defined(__AVX2__)
+  __m256d best = _mm256_set1_pd(INF);
+  __m256d bestIndex = _mm256_setzero_pd();
+  __m256d index = _mm256_setr_pd(0, 1, 2, 3);
+  const __m256d step = _mm256_set1_pd(4);
+  for (; i + 4 <= count; i += 4) {
+    __m256d weight = _mm256_max_pd(_mm256_loadu_pd(weights + i),
+                                   _mm256_loadu_pd(done + i));
+    __m256d d = _mm256_loadu_pd(dist + i);
+    __m256d lower = _mm256_cmp_pd(weight, d, _CMP_LT_OQ);
+    int bits = _mm256_movemask_pd(lower);
+    if (bits) {
+      d = _mm256_blendv_pd(d, weight, lower);
+      _mm256_storeu_pd(dist + i, d);
+      // few entries are ever lowered, so the parents go one at a time
+      for (; bits; bits &= bits - 1) {
+        parent[i + __builtin_ctz(bits)] = from;
+      }
+    }
+    __m256d less = _mm256_cmp_pd(d, best, _CMP_LT_OQ);
+    best = _mm256_blendv_pd(best, d, less);
+    bestIndex = _mm256_blendv_pd(bestIndex, index, less);
+    index = _mm256_add_pd(index, step);
+  }
+  double lanes[4];
+  double laneIndices[4];
+  _mm256_storeu_pd(lanes, best);
+  _mm256_storeu_pd(laneIndices, bestIndex);
+  for (size_t lane = 0; lane < 4; ++lane) {
+    if (lanes[lane] < min) {
+      min = lanes[lane];
+      argmin = laneIndices[lane];
+    }
+  }
+#endif
+
+  // the scalar loop, or what is left over from the vector one
+  for (; i < count; ++i) {
+    double weight = weights[i] > done[i] ? weights[i] : done[i];
+    if (weight < dist[i]) {
+      dist[i] = weight;
+      parent[i] = from;
+    }
+    if (dist[i] < min) {
+      min = dist[i];
+      argmin = i;
+    }
+  }
+  return argmin;
+}
+
+#endif
@@ -0,0 +1,103 @@
+/*
+ * Times DensePrim on complete graphs over random points in the unit cube,
+ * weighted by Euclidean distance, once from the distance matrix and once
+ * from the distance function through DensePrim::complete, against
+ * Prim::mst with a heap on the same graph as a CSRGraph and on neighbors
+ * generated from the distance function. Building the matrix and the
+ * CSRGraph is not timed. Compile with -march=native or
+ * -mavx2 to get the vector scans.
+ *
+ * usage: DensePrimBench [maxVertices] [dimensions]
+ */
+
+#include "CSRGraph.hh"
+#include "DensePrim.hh"
+#include "Prim.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+  size_t maxVertices = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 8000;
+  size_t dimensions = argc > 2 ? std::strtoull(argv[2], NULL, 10) : 8;
+
+#if defined(__AVX512F__)
+  std::cout << "scans use AVX-512" << std::endl;
+#elif defined(__AVX2__)
+  std::cout << "scans use AVX2" << std::endl;
+#else
+  std::cout << "scans are scalar" << std::endl;
+#endif
+  std::cout << "n       matrix(s)   distance(s) prim(s)     prim 4-ary(s) "
+            << "generated(s)" << std::endl;
+  for (size_t n = 1000; n <= maxVertices; n *= 2) {
+    std::mt19937_64 rng(n);
+    std::uniform_real_distribution<double> coordinate(0.0, 1.0);
+    std::vector<double> points(n * dimensions);
+    for (double& value : points) value = coordinate(rng);
+    auto distance = [&](size_t one, size_t two) {
+      double sum = 0;
+      for (size_t k = 0; k < dimensions; k++) {
+        double delta = points[one * dimensions + k] -
+          points[two * dimensions + k];
+        sum += delta * delta;
+      }
+      return std::sqrt(sum);
+    };
+
+    std::vector<double> matrix(n * n);
+    std::vector<CSRGraph::Edge> edges;
+    edges.reserve(n * (n - 1) / 2);
+    for (size_t i = 0; i < n; i++) {
+      for (size_t j = 0; j < n; j++) {
+        matrix[i * n + j] = distance(i, j);
+        if (i < j) {
+          CSRGraph::Edge edge = { (uint32_t) i, (uint32_t) j,
+            matrix[i * n + j] };
+          edges.push_back(edge);
+        }
+      }
+    }
+    CSRGraph graph(n, edges);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<CSRGraph::Edge> tree = DensePrim::mst(n, matrix);
+    double matrixTime = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    DensePrim::complete(n, distance);
+    double distanceTime = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    Prim<uint32_t>::mst(graph);
+    double primTime = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    Prim<uint32_t, IndexedDaryHeap<4> >::mst(graph);
+    double daryTime = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    Prim<uint32_t, IndexedDaryHeap<4> >::mst(n,
+      [&](uint32_t vertex, auto visit) {
+        for (size_t i = 0; i < n; i++) {
+          if (i != vertex) visit(i, distance(vertex, i));
+        }
+      });
+    double generatedTime = secondsSince(start);
+
+    std::cout << n << "    " << matrixTime << "    " << distanceTime << "    "
+              << primTime << "    " << daryTime << "    " << generatedTime
+              << std::endl;
+  }
+  return 0;
+}
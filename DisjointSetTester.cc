@@ -0,0 +1,152 @@
+#include "FlatDisjointSet.hh"
+#include "ConcurrentDisjointSet.hh"
+#include "FlatDisjointSetForest.hh"
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// checks the union-find against a naive component labelling
+static void testFlatDisjointSet() {
+  const size_t n = 2000;
+  FlatDisjointSet sets(n);
+  std::vector<uint32_t> label(n);
+  for (size_t i = 0; i < n; i++) label[i] = i;
+  assert(sets.numSets() == n);
+
+  std::mt19937 rng(7);
+  for (int step = 0; step < 1500; step++) {
+    uint32_t one = rng() % n;
+    uint32_t two = rng() % n;
+    uint32_t root = sets.unionSets(one, two);
+    assert(root == sets.find(one) && root == sets.find(two));
+    uint32_t from = label[two];
+    for (size_t i = 0; i < n; i++) {
+      if (label[i] == from) label[i] = label[one];
+    }
+  }
+
+  size_t numLabels = 0;
+  std::vector<uint32_t> counts(n, 0);
+  for (size_t i = 0; i < n; i++) {
+    if (counts[label[i]]++ == 0) numLabels++;
+  }
+  assert(sets.numSets() == numLabels);
+
+  std::vector<uint32_t> ids(n);
+  std::vector<uint32_t> roots(n);
+  for (size_t i = 0; i < n; i++) ids[i] = rng() % n;
+  sets.findBatch(ids.data(), n, roots.data());
+  for (size_t i = 0; i < n; i++) {
+    assert(roots[i] == sets.find(ids[i]));
+    assert(sets.setSize(ids[i]) == counts[label[ids[i]]]);
+    assert(sets.sameSet(ids[i], ids[0]) == (label[ids[i]] == label[ids[0]]));
+  }
+
+  sets.reset();
+  assert(sets.numSets() == n);
+  assert(!sets.sameSet(0, 1));
+}
+
+// four threads union disjoint slices of the same edge list, the result
+// must partition the ids exactly like a serial run over all of it
+static void testConcurrentDisjointSet() {
+  const size_t n = 100000;
+  const size_t m = 80000;
+  std::mt19937 rng(11);
+  std::vector<uint32_t> first(m);
+  std::vector<uint32_t> second(m);
+  for (size_t i = 0; i < m; i++) {
+    first[i] = rng() % n;
+    second[i] = rng() % n;
+  }
+
+  FlatDisjointSet serial(n);
+  for (size_t i = 0; i < m; i++) serial.unionSets(first[i], second[i]);
+
+  ConcurrentDisjointSet sets(n);
+  std::vector<std::thread> threads;
+  std::vector<size_t> merges(4, 0);
+  for (size_t t = 0; t < 4; t++) {
+    threads.push_back(std::thread([&, t]() {
+      for (size_t i = t; i < m; i += 4) {
+        if (sets.unionSets(first[i], second[i])) merges[t]++;
+      }
+    }));
+  }
+  for (std::thread& thread : threads) thread.join();
+
+  assert(merges[0] + merges[1] + merges[2] + merges[3] ==
+         n - serial.numSets());
+  for (size_t i = 0; i < m; i++) {
+    uint32_t other = rng() % n;
+    assert(sets.sameSet(first[i], other) ==
+           serial.sameSet(first[i], other));
+    assert(sets.find(first[i]) == sets.find(second[i]));
+  }
+}
+
+// contracts random batches and compares the surviving edges with the
+// lightest edge between every pair of naively labelled components
+static void testFlatDisjointSetForest() {
+  const size_t n = 3000;
+  std::mt19937 rng(5);
+  std::vector<CSRGraph::Edge> edges;
+  for (size_t i = 0; i < 20000; i++) {
+    CSRGraph::Edge edge = { (uint32_t) (rng() % n), (uint32_t) (rng() % n),
+      (double) (rng() % 500) };
+    edges.push_back(edge);
+  }
+  FlatDisjointSetForest forest(n, edges);
+  FlatDisjointSet naive(n);
+
+  while (forest.numEdges() > 0) {
+    std::vector<size_t> batch;
+    for (size_t i = 0; i < forest.numEdges(); i += 1 + rng() % 40) {
+      batch.push_back(i);
+    }
+    for (size_t i : batch) {
+      const CSRGraph::Edge& edge = edges[forest.getEdges()[i].origin];
+      naive.unionSets(edge.first, edge.second);
+    }
+    forest.contractEdges(batch);
+    assert(forest.size() == naive.numSets());
+
+    std::map<std::pair<uint32_t, uint32_t>, double> lightest;
+    for (const CSRGraph::Edge& edge : edges) {
+      uint32_t one = naive.find(edge.first);
+      uint32_t two = naive.find(edge.second);
+      if (one == two) continue;
+      std::pair<uint32_t, uint32_t> key(std::min(one, two), std::max(one, two));
+      if (!lightest.count(key) || edge.weight < lightest[key]) {
+        lightest[key] = edge.weight;
+      }
+    }
+    assert(forest.numEdges() == lightest.size());
+    for (const FlatDisjointSetForest::Edge& edge : forest.getEdges()) {
+      const CSRGraph::Edge& input = edges[edge.origin];
+      assert(edge.first < edge.second);
+      assert(forest.superNodeOf(input.first) != forest.superNodeOf(input.second));
+      assert(std::min(forest.superNodeOf(input.first),
+                      forest.superNodeOf(input.second)) == edge.first);
+      uint32_t one = naive.find(input.first);
+      uint32_t two = naive.find(input.second);
+      std::pair<uint32_t, uint32_t> key(std::min(one, two), std::max(one, two));
+      assert(edge.weight == input.weight && lightest[key] == edge.weight);
+    }
+  }
+  assert(forest.sameSuperNode(edges[0].first, edges[0].second));
+}
+
+int main() {
+  testFlatDisjointSet();
+  testConcurrentDisjointSet();
+  testFlatDisjointSetForest();
+  std::cout << "all disjoint set tests passed" << std::endl;
+  return 0;
+}
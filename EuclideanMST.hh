@@ -0,0 +1,320 @@
+/*
+ * Euclidean MST
+ *
+ * Minimum spanning trees of point sets in D dimensions under Euclidean
+ * distance, without ever listing the n^2 pairs. The points go into a
+ * kd-tree, and dual-tree Boruvka (March, Ram and Gray 2010) then finds each
+ * component's nearest point in another component for all components at once
+ * by walking pairs of tree nodes:
+ *
+ *  - a node whose points all share a component remembers it, and a pair of
+ *    nodes in the same component is skipped;
+ *  - a node keeps a bound, the worst of its points' components' best
+ *    candidate distances so far, and a pair of nodes further apart than
+ *    the query node's bound is skipped;
+ *  - the nearer child of a node is visited first, so bounds tighten early.
+ *
+ * Every round merges each component along its candidate in the repo's
+ * FlatDisjointSet, at least halving their number, which makes O(log n)
+ * rounds of close to O(n) work each on well spread points. Candidates are
+ * ordered by squared distance and then by the two point ids, so ties can't
+ * close a cycle. The tree holds the points in its own order, and the union-
+ * find works on those positions; edges come back in the input's ids with
+ * the distance as weight.
+ */
+
+#ifndef EuclideanMST_Included
+#define EuclideanMST_Included
+
+#include "CSRGraph.hh"
+#include "FlatDisjointSet.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+template <size_t D>
+class EuclideanMST {
+  public:
+    static constexpr size_t LEAF_SIZE = 16;
+
+    // points holds numPoints points of D coordinates one after another;
+    // returns the tree edges between point ids, weighted by distance
+    static std::vector<CSRGraph::Edge> mst(size_t numPoints,
+                                           const double *points);
+    static std::vector<CSRGraph::Edge> mst(const std::vector<double>& points);
+
+  private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Node {
+      double mLow[D];
+      double mHigh[D];
+      uint32_t mBegin;
+      uint32_t mEnd;
+      // children, NONE for a leaf
+      uint32_t mLeft;
+      uint32_t mRight;
+      // the component of all the points, NONE if they are in several
+      uint32_t mComponent;
+      double mBound;
+    };
+
+    // the lightest edge leaving a component found so far, by position
+    struct Candidate {
+      double mDistance;
+      uint32_t mFrom;
+      uint32_t mTo;
+    };
+
+    const size_t mNumPoints;
+    // the coordinates in tree order and the input id at each position
+    std::vector<double> mPoints;
+    std::vector<uint32_t> mIds;
+    std::vector<Node> mNodes;
+    FlatDisjointSet mSets;
+    // the component of each position for the current round
+    std::vector<uint32_t> mComponent;
+    std::vector<Candidate> mCandidates;
+
+    EuclideanMST(size_t numPoints, const double *points);
+
+    std::vector<CSRGraph::Edge> run();
+    uint32_t build(uint32_t begin, uint32_t end,
+                   const double *points, std::vector<uint32_t>& order);
+    // refreshes mComponent and every node's component and bound
+    uint32_t label(uint32_t node);
+    void search(uint32_t query, uint32_t reference);
+    void searchLeaves(Node& query, const Node& reference);
+    inline double distance(uint32_t one, uint32_t two) const;
+    inline double distance(const Node& one, const Node& two) const;
+    // whether the edge from, to is lighter than candidate, ties broken by
+    // the input ids so every component agrees on one order
+    inline bool lighter(double distance, uint32_t from, uint32_t to,
+                        const Candidate& candidate) const;
+};
+
+template <size_t D>
+std::vector<CSRGraph::Edge> EuclideanMST<D>::mst(size_t numPoints,
+                                                 const double *points) {
+  if (numPoints < 2) return std::vector<CSRGraph::Edge>();
+  EuclideanMST<D> engine(numPoints, points);
+  return engine.run();
+}
+
+template <size_t D>
+std::vector<CSRGraph::Edge> EuclideanMST<D>::mst(
+    const std::vector<double>& points) {
+  return mst(points.size() / D, points.data());
+}
+
+template <size_t D>
+EuclideanMST<D>::EuclideanMST(size_t numPoints, const double *points) :
+  mNumPoints(numPoints), mPoints(numPoints * D), mIds(numPoints),
+  mSets(numPoints), mComponent(numPoints), mCandidates(numPoints) {
+  std::vector<uint32_t> order(numPoints);
+  for (size_t i = 0; i < numPoints; ++i) order[i] = i;
+  mNodes.reserve(2 * (numPoints / LEAF_SIZE + 1));
+  build(0, numPoints, points, order);
+  for (size_t i = 0; i < numPoints; ++i) {
+    mIds[i] = order[i];
+    for (size_t k = 0; k < D; ++k) {
+      mPoints[i * D + k] = points[order[i] * D + k];
+    }
+  }
+}
+
+// splits on the widest dimension at the median, so the tree is balanced
+template <size_t D>
+uint32_t EuclideanMST<D>::build(uint32_t begin, uint32_t end,
+                                const double *points,
+                                std::vector<uint32_t>& order) {
+  uint32_t index = mNodes.size();
+  mNodes.push_back(Node());
+  Node node;
+  node.mBegin = begin;
+  node.mEnd = end;
+  node.mLeft = node.mRight = NONE;
+  for (size_t k = 0; k < D; ++k) {
+    node.mLow[k] = std::numeric_limits<double>::infinity();
+    node.mHigh[k] = -std::numeric_limits<double>::infinity();
+  }
+  for (uint32_t i = begin; i < end; ++i) {
+    for (size_t k = 0; k < D; ++k) {
+      double coordinate = points[order[i] * D + k];
+      node.mLow[k] = std::min(node.mLow[k], coordinate);
+      node.mHigh[k] = std::max(node.mHigh[k], coordinate);
+    }
+  }
+
+  size_t widest = 0;
+  for (size_t k = 1; k < D; ++k) {
+    double width = node.mHigh[k] - node.mLow[k];
+    if (width > node.mHigh[widest] - node.mLow[widest]) widest = k;
+  }
+  // a box of one point can't be split, however many copies of it there are
+  if (end - begin > LEAF_SIZE && node.mHigh[widest] > node.mLow[widest]) {
+    uint32_t middle = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + middle,
+                     order.begin() + end,
+                     [&](uint32_t one, uint32_t two) {
+                       return points[one * D + widest] <
+                         points[two * D + widest];
+                     });
+    node.mLeft = build(begin, middle, points, order);
+    node.mRight = build(middle, end, points, order);
+  }
+  mNodes[index] = node;
+  return index;
+}
+
+template <size_t D>
+std::vector<CSRGraph::Edge> EuclideanMST<D>::run() {
+  std::vector<CSRGraph::Edge> result;
+  result.reserve(mNumPoints - 1);
+  while (mSets.numSets() > 1) {
+    label(0);
+    for (size_t i = 0; i < mNumPoints; ++i) {
+      mCandidates[i].mDistance = std::numeric_limits<double>::infinity();
+    }
+    search(0, 0);
+
+    for (size_t i = 0; i < mNumPoints; ++i) {
+      if (mComponent[i] != i) continue;
+      const Candidate& candidate = mCandidates[i];
+      if (mSets.sameSet(candidate.mFrom, candidate.mTo)) continue;
+      mSets.unionSets(candidate.mFrom, candidate.mTo);
+      CSRGraph::Edge edge = { mIds[candidate.mFrom], mIds[candidate.mTo],
+        std::sqrt(candidate.mDistance) };
+      result.push_back(edge);
+    }
+  }
+  return result;
+}
+
+template <size_t D>
+uint32_t EuclideanMST<D>::label(uint32_t index) {
+  Node& node = mNodes[index];
+  node.mBound = std::numeric_limits<double>::infinity();
+  if (node.mLeft == NONE) {
+    node.mComponent = mComponent[node.mBegin] = mSets.find(node.mBegin);
+    for (uint32_t i = node.mBegin + 1; i < node.mEnd; ++i) {
+      mComponent[i] = mSets.find(i);
+      if (mComponent[i] != node.mComponent) node.mComponent = NONE;
+    }
+  } else {
+    uint32_t left = label(node.mLeft);
+    uint32_t right = label(node.mRight);
+    node.mComponent = left == right ? left : NONE;
+  }
+  return node.mComponent;
+}
+
+template <size_t D>
+void EuclideanMST<D>::search(uint32_t queryIndex, uint32_t referenceIndex) {
+  Node& query = mNodes[queryIndex];
+  const Node& reference = mNodes[referenceIndex];
+  if (query.mComponent != NONE && query.mComponent == reference.mComponent) {
+    return;
+  }
+  if (distance(query, reference) > query.mBound) return;
+
+  if (query.mLeft == NONE && reference.mLeft == NONE) {
+    searchLeaves(query, reference);
+    return;
+  }
+
+  if (query.mLeft == NONE) {
+    // descend the reference side only, nearer child first
+    uint32_t near = reference.mLeft;
+    uint32_t far = reference.mRight;
+    if (distance(query, mNodes[far]) < distance(query, mNodes[near])) {
+      std::swap(near, far);
+    }
+    search(queryIndex, near);
+    search(queryIndex, far);
+    return;
+  }
+
+  uint32_t children[2] = { query.mLeft, query.mRight };
+  for (uint32_t child : children) {
+    if (reference.mLeft == NONE) {
+      search(child, referenceIndex);
+      continue;
+    }
+    uint32_t near = reference.mLeft;
+    uint32_t far = reference.mRight;
+    if (distance(mNodes[child], mNodes[far]) <
+        distance(mNodes[child], mNodes[near])) {
+      std::swap(near, far);
+    }
+    search(child, near);
+    search(child, far);
+  }
+  // a query node is done with reference once both children are
+  query.mBound = std::max(mNodes[query.mLeft].mBound,
+                          mNodes[query.mRight].mBound);
+}
+
+template <size_t D>
+void EuclideanMST<D>::searchLeaves(Node& query, const Node& reference) {
+  double bound = 0;
+  for (uint32_t q = query.mBegin; q < query.mEnd; ++q) {
+    uint32_t component = mComponent[q];
+    Candidate& candidate = mCandidates[component];
+    for (uint32_t r = reference.mBegin; r < reference.mEnd; ++r) {
+      if (mComponent[r] == component) continue;
+      double d = distance(q, r);
+      if (d <= candidate.mDistance && lighter(d, q, r, candidate)) {
+        candidate.mDistance = d;
+        candidate.mFrom = q;
+        candidate.mTo = r;
+      }
+    }
+    bound = std::max(bound, candidate.mDistance);
+  }
+  query.mBound = bound;
+}
+
+template <size_t D>
+inline double EuclideanMST<D>::distance(uint32_t one, uint32_t two) const {
+  const double *first = &mPoints[one * D];
+  const double *second = &mPoints[two * D];
+  double sum = 0;
+  for (size_t k = 0; k < D; ++k) {
+    double delta = first[k] - second[k];
+    sum += delta * delta;
+  }
+  return sum;
+}
+
+// the squared distance between the closest points of two boxes
+template <size_t D>
+inline double EuclideanMST<D>::distance(const Node& one,
+                                        const Node& two) const {
+  double sum = 0;
+  for (size_t k = 0; k < D; ++k) {
+    double gap = std::max(one.mLow[k] - two.mHigh[k],
+                          two.mLow[k] - one.mHigh[k]);
+    if (gap > 0) sum += gap * gap;
+  }
+  return sum;
+}
+
+template <size_t D>
+inline bool EuclideanMST<D>::lighter(double distance, uint32_t from,
+                                     uint32_t to,
+                                     const Candidate& candidate) const {
+  if (distance != candidate.mDistance) return distance < candidate.mDistance;
+  uint32_t low = std::min(mIds[from], mIds[to]);
+  uint32_t high = std::max(mIds[from], mIds[to]);
+  uint32_t candidateLow = std::min(mIds[candidate.mFrom], mIds[candidate.mTo]);
+  uint32_t candidateHigh = std::max(mIds[candidate.mFrom],
+                                    mIds[candidate.mTo]);
+  return low < candidateLow || (low == candidateLow && high < candidateHigh);
+}
+
+#endif
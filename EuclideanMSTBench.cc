@@ -0,0 +1,63 @@
+/*
+ * Times EuclideanMST on uniform random points in the unit square and cube
+ * against DensePrim::complete on the same points, which is O(n^2) and so
+ * only runs up to maxDense points.
+ *
+ * usage: EuclideanMSTBench [maxPoints] [maxDense]
+ */
+
+#include "CSRGraph.hh"
+#include "DensePrim.hh"
+#include "EuclideanMST.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+template <size_t D>
+static void bench(size_t maxPoints, size_t maxDense) {
+  std::cout << "dimensions " << D << std::endl;
+  std::cout << "n         euclidean(s)  dense(s)" << std::endl;
+  for (size_t n = 10000; n <= maxPoints; n *= 4) {
+    std::mt19937_64 rng(n);
+    std::uniform_real_distribution<double> coordinate(0.0, 1.0);
+    std::vector<double> points(n * D);
+    for (double& value : points) value = coordinate(rng);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<CSRGraph::Edge> tree = EuclideanMST<D>::mst(points);
+    double treeTime = secondsSince(start);
+    std::cout << n << "     " << treeTime;
+
+    if (n <= maxDense) {
+      start = std::chrono::steady_clock::now();
+      DensePrim::complete(n, [&](uint32_t one, uint32_t two) {
+        double sum = 0;
+        for (size_t k = 0; k < D; k++) {
+          double delta = points[one * D + k] - points[two * D + k];
+          sum += delta * delta;
+        }
+        return std::sqrt(sum);
+      });
+      std::cout << "     " << secondsSince(start);
+    }
+    std::cout << std::endl;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  size_t maxPoints = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 2560000;
+  size_t maxDense = argc > 2 ? std::strtoull(argv[2], NULL, 10) : 40000;
+  bench<2>(maxPoints, maxDense);
+  bench<3>(maxPoints, maxDense);
+  return 0;
+}
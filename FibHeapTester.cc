@@ -1,6 +1,97 @@
 #include "FibonacciHeap.hh"
 #include <iostream>
+#include <algorithm>
 #include <cassert>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// random enqueues, decreaseKeys and extractMins checked against a multimap
+// keyed by priority, leaving entries behind for the destructor
+template <template <typename> class Allocator>
+void testRandom() {
+  typedef FibonacciHeap<std::string, Allocator> Heap;
+  std::mt19937 rng(12);
+  Heap heap;
+  std::vector<typename Heap::Entry *> entries;
+  std::vector<std::string> values;
+  std::multimap<double, std::string> reference;
+  for (int round = 0; round < 20000; round++) {
+    int op = rng() % 4;
+    if (op == 0 && !heap.isEmpty()) {
+      typename Heap::Element min = heap.extractMin();
+      assert(min.getPriority() == reference.begin()->first);
+      std::multimap<double, std::string>::iterator it =
+        reference.find(min.getPriority());
+      while (it->second != min.getValue()) ++it;
+      reference.erase(it);
+      for (size_t i = 0; i < values.size(); i++) {
+        if (values[i] == min.getValue()) {
+          entries[i] = entries.back();
+          entries.pop_back();
+          values[i] = values.back();
+          values.pop_back();
+          break;
+        }
+      }
+    } else if (op == 1 && !entries.empty()) {
+      typename Heap::Entry *entry = entries[rng() % entries.size()];
+      double priority = entry->getPriority() - (rng() % 100);
+      std::multimap<double, std::string>::iterator it =
+        reference.find(entry->getPriority());
+      while (it->second != entry->getValue()) ++it;
+      reference.erase(it);
+      reference.insert(std::make_pair(priority, entry->getValue()));
+      heap.decreaseKey(*entry, priority);
+    } else {
+      std::string value = "value " + std::to_string(round);
+      double priority = rng() % 1000;
+      entries.push_back(&heap.enqueue(value, priority));
+      values.push_back(value);
+      reference.insert(std::make_pair(priority, value));
+    }
+    assert(heap.size() == reference.size());
+    if (!heap.isEmpty()) {
+      assert(heap.findMin().getPriority() == reference.begin()->first);
+    }
+  }
+}
+
+// batches of every size, between decreaseKeys and single extracts, come
+// out as the sorted priorities would
+void testBatch() {
+  std::mt19937 rng(21);
+  FibonacciHeap<int> heap;
+  std::vector<FibonacciHeap<int>::Entry *> entries;
+  for (int i = 0; i < 5000; i++) {
+    entries.push_back(&heap.enqueue(i, rng() % 100000));
+  }
+  std::vector<double> byValue;
+  for (FibonacciHeap<int>::Entry *entry : entries) {
+    if (rng() % 4 == 0) heap.decreaseKey(*entry, entry->getPriority() / 2);
+    byValue.push_back(entry->getPriority());
+  }
+  std::vector<double> priorities = byValue;
+  std::sort(priorities.begin(), priorities.end());
+
+  size_t taken = 0;
+  for (size_t count = 0; taken < priorities.size(); count++) {
+    std::vector<FibonacciHeap<int>::Element> batch =
+      heap.extractMinBatch(count);
+    assert(batch.size() == std::min(count, priorities.size() - taken));
+    for (const FibonacciHeap<int>::Element& element : batch) {
+      assert(element.getPriority() == priorities[taken++]);
+      assert(byValue[element.getValue()] == element.getPriority());
+    }
+    assert(heap.size() == priorities.size() - taken);
+    if (taken < priorities.size() && count % 3 == 0) {
+      assert(heap.extractMin().getPriority() == priorities[taken++]);
+    }
+  }
+  assert(heap.isEmpty());
+  assert(heap.extractMinBatch(4).empty());
+}
 
 int main(int argc, char *argv[]) {
   FibonacciHeap<int> heap;
@@ -25,5 +116,23 @@ int main(int argc, char *argv[]) {
 
   delete &newHeap;
 
+  // extracted entries are recycled by the slab allocator
+  FibonacciHeap<int> recycling;
+  FibonacciHeap<int>::Entry *first = &recycling.enqueue(1, 1);
+  assert(recycling.extractMin().getValue() == 1);
+  assert(&recycling.enqueue(2, 2) == first);
+
+  // melding with an empty heap
+  FibonacciHeap<int> empty;
+  FibonacciHeap<int>& alone = FibonacciHeap<int>::meld(recycling, empty);
+  assert(alone.getSize() == 1);
+  assert(alone.extractMin().getValue() == 2);
+  assert(alone.isEmpty());
+  delete &alone;
+
+  testRandom<SlabAllocator>();
+  testRandom<NewDeleteAllocator>();
+  testBatch();
+
   return 0;
 }
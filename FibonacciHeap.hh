@@ -11,17 +11,25 @@
 #ifndef FibonacciHeap_Included
 #define FibonacciHeap_Included
 
+#include "SlabAllocator.hh"
+
+#include <algorithm>
 #include <cstddef>
+#include <utility>
 #include <vector>
 #include <iostream>
 
-template <typename T>
+// Entries come from the Allocator policy (see SlabAllocator.hh), which the
+// heap owns. An Entry is a handle for decreaseKey until it is extracted;
+// extractMin returns its value and priority and recycles the Entry, and
+// whatever is left is released with the heap. Consolidation links roots
+// through a degree table kept in the heap, so extracting allocates nothing.
+template <typename T, template <typename> class Allocator = SlabAllocator>
 class FibonacciHeap {
   public:
     class Entry {
       public:
         Entry(const T& value, double priority);
-        ~Entry();
 
         inline const T& getValue() const;
         inline void setValue(const T& newValue);
@@ -50,6 +58,19 @@ class FibonacciHeap {
         void operator=(Entry const &) = delete;
     };
 
+    // what extractMin hands back once the entry itself is gone
+    class Element {
+      public:
+        Element(const T& value, double priority);
+
+        inline const T& getValue() const;
+        inline double getPriority() const;
+
+      private:
+        T mValue;
+        double mPriority;
+    };
+
     FibonacciHeap(); 
     ~FibonacciHeap();
 
@@ -61,19 +82,41 @@ class FibonacciHeap {
     inline Entry& findMin() const; 
 
     Entry& enqueue(const T& value, double priority);
-    // object returned MUST BE FREED after use
-    Entry& extractMin();
+    Element extractMin();
+    // the count smallest elements in order, fewer if the heap runs out; the
+    // roots are consolidated once for the whole batch
+    std::vector<Element> extractMinBatch(size_t count);
     void decreaseKey(Entry& entry, double newPriority);
 
-    // object returned MUST BE FREED after use
-    static FibonacciHeap<T>& meld(FibonacciHeap<T>& first,
-        FibonacciHeap<T>& second);
+    // object returned MUST BE FREED after use, the entries and their memory
+    // move to it and first and second are left empty
+    static FibonacciHeap<T, Allocator>& meld(FibonacciHeap<T, Allocator>& first,
+        FibonacciHeap<T, Allocator>& second);
 
   private:
+    // a root of degree d has at least phi^d descendants, so no heap that
+    // fits in a 64 bit address space gets past degree 92
+    static constexpr size_t MAX_DEGREE = 93;
+
     Entry *mMin;
     size_t mSize;
-
+    Allocator<Entry> mAllocator;
+    // the root of each degree during consolidate, all NULL in between
+    Entry *mDegrees[MAX_DEGREE];
+    // extractMinBatch's heap of the roots it may take next, with their
+    // priorities alongside so comparing never touches the entries
+    std::vector<std::pair<double, Entry *> > mBatch;
+
+    // unlinks root from the root list, promotes its children and recycles
+    // it; mMin is left at some root, not necessarily the smallest
+    Element removeRoot(Entry *root);
+    // links roots of equal degree until no two are left, then points mMin
+    // at the smallest
+    void consolidate();
+    static inline bool later(const std::pair<double, Entry *>& one,
+                             const std::pair<double, Entry *>& two);
     void cutNode(Entry &entry);
+    void release(Entry *list);
     static void mergeLists(Entry *one, Entry *two);
 
     FibonacciHeap(FibonacciHeap const &) = delete;
@@ -81,195 +124,255 @@ class FibonacciHeap {
 };
 
 /* Entry constructor */
-template <typename T>
-FibonacciHeap<T>::Entry::Entry(const T& value, double priority) :
+template <typename T, template <typename> class Allocator>
+FibonacciHeap<T, Allocator>::Entry::Entry(const T& value, double priority) :
   mValue(value), mPriority(priority), mParent(NULL), mChild(NULL), 
   mNext(this), mPrev(this), marked(false), mDegree(0) {
     // Handled in initializer list.
   }
 
-// Entry destructor, recursively deletes all children and iteratively
-// and iteratively deletes all siblings. If you don't want to destroy
-// the siblings, make sure this node has no siblings before deleting it.
-template <typename T>
-FibonacciHeap<T>::Entry::~Entry() {
-  if (mChild) {
-    delete mChild;
-  }
-  while (mNext != this) {
-    Entry *next = mNext;
-    mNext = mNext->mNext;
-    next->mNext = next;
-    delete next;
-  }
-}
-
-template <typename T>
-inline const T& FibonacciHeap<T>::Entry::getValue() const {
+template <typename T, template <typename> class Allocator>
+inline const T& FibonacciHeap<T, Allocator>::Entry::getValue() const {
   return mValue;
 }
 
-template <typename T>
-inline void FibonacciHeap<T>::Entry::setValue(const T& newValue) {
+template <typename T, template <typename> class Allocator>
+inline void FibonacciHeap<T, Allocator>::Entry::setValue(const T& newValue) {
   mValue = newValue;
 }
 
-template <typename T>
-inline double FibonacciHeap<T>::Entry::getPriority() const {
+template <typename T, template <typename> class Allocator>
+inline double FibonacciHeap<T, Allocator>::Entry::getPriority() const {
   return mPriority;
 }
 
-template <typename T>
-inline void FibonacciHeap<T>::Entry::setPriority(const double newPriority) {
+template <typename T, template <typename> class Allocator>
+inline void FibonacciHeap<T, Allocator>::Entry::setPriority(const double newPriority) {
   mPriority = newPriority;
 }
 
-template <typename T>
-inline bool FibonacciHeap<T>::Entry::isMarked() const {
+template <typename T, template <typename> class Allocator>
+inline bool FibonacciHeap<T, Allocator>::Entry::isMarked() const {
   return marked;
 }
 
-template <typename T>
-inline void FibonacciHeap<T>::Entry::mark() {
+template <typename T, template <typename> class Allocator>
+inline void FibonacciHeap<T, Allocator>::Entry::mark() {
   marked = true;
 }
 
-template <typename T>
-inline void FibonacciHeap<T>::Entry::unmark() {
+template <typename T, template <typename> class Allocator>
+inline void FibonacciHeap<T, Allocator>::Entry::unmark() {
   marked = false;
 }
 
-template <typename T>
-inline int FibonacciHeap<T>::Entry::getDegree() const {
+template <typename T, template <typename> class Allocator>
+inline int FibonacciHeap<T, Allocator>::Entry::getDegree() const {
   return mDegree;
 }
 
-template <typename T>
-inline void FibonacciHeap<T>::Entry::increaseDegree() {
+template <typename T, template <typename> class Allocator>
+inline void FibonacciHeap<T, Allocator>::Entry::increaseDegree() {
   mDegree++;
 }
 
-template <typename T>
-inline void FibonacciHeap<T>::Entry::decreaseDegree() {
+template <typename T, template <typename> class Allocator>
+inline void FibonacciHeap<T, Allocator>::Entry::decreaseDegree() {
   mDegree--;
 }
 
-template <typename T>
-FibonacciHeap<T>::FibonacciHeap() : mSize(0), mMin(NULL) {
+template <typename T, template <typename> class Allocator>
+FibonacciHeap<T, Allocator>::Element::Element(const T& value,
+    double priority) : mValue(value), mPriority(priority) {
+  // Handled in initializer list.
+}
+
+template <typename T, template <typename> class Allocator>
+inline const T& FibonacciHeap<T, Allocator>::Element::getValue() const {
+  return mValue;
+}
+
+template <typename T, template <typename> class Allocator>
+inline double FibonacciHeap<T, Allocator>::Element::getPriority() const {
+  return mPriority;
+}
+
+template <typename T, template <typename> class Allocator>
+FibonacciHeap<T, Allocator>::FibonacciHeap() : mMin(NULL), mSize(0),
+  mDegrees() {
   // Handled in initializer list.
 }
 
-template <typename T>
-FibonacciHeap<T>::~FibonacciHeap() {
-  delete mMin;
+template <typename T, template <typename> class Allocator>
+FibonacciHeap<T, Allocator>::~FibonacciHeap() {
+  release(mMin);
+}
+
+template <typename T, template <typename> class Allocator>
+void FibonacciHeap<T, Allocator>::release(Entry *list) {
+  // destroys every entry reachable from list, children and siblings alike,
+  // with an explicit stack so deep trees don't recurse
+  if (!list) return;
+  std::vector<Entry *> stack(1, list);
+  while (!stack.empty()) {
+    Entry *first = stack.back();
+    stack.pop_back();
+    Entry *cur = first;
+    do {
+      Entry *next = cur->mNext;
+      if (cur->mChild) stack.push_back(cur->mChild);
+      cur->~Entry();
+      mAllocator.deallocate(cur);
+      cur = next;
+    } while (cur != first);
+  }
 }
 
-template <typename T>
-inline size_t FibonacciHeap<T>::size() const {
+template <typename T, template <typename> class Allocator>
+inline size_t FibonacciHeap<T, Allocator>::size() const {
   return mSize;
 }
 
-template <typename T>
-inline bool FibonacciHeap<T>::isEmpty() const {
+template <typename T, template <typename> class Allocator>
+inline bool FibonacciHeap<T, Allocator>::isEmpty() const {
   return mSize == 0;
 }
 
-template <typename T>
-inline size_t FibonacciHeap<T>::getSize() const {
+template <typename T, template <typename> class Allocator>
+inline size_t FibonacciHeap<T, Allocator>::getSize() const {
   return mSize;
 }
 
-template <typename T>
-inline void FibonacciHeap<T>::setSize(const size_t newSize) {
+template <typename T, template <typename> class Allocator>
+inline void FibonacciHeap<T, Allocator>::setSize(const size_t newSize) {
   mSize = newSize;
 }
 
-template <typename T>
-inline void FibonacciHeap<T>::setMin(Entry *newMin) {
+template <typename T, template <typename> class Allocator>
+inline void FibonacciHeap<T, Allocator>::setMin(Entry *newMin) {
   mMin = newMin;
 }
 
-template <typename T>
-inline typename FibonacciHeap<T>::Entry& FibonacciHeap<T>::findMin() const {
+template <typename T, template <typename> class Allocator>
+inline typename FibonacciHeap<T, Allocator>::Entry& FibonacciHeap<T, Allocator>::findMin() const {
   // doesn't work if empty
   return *mMin;
 }
 
-template <typename T>
-typename FibonacciHeap<T>::Entry& FibonacciHeap<T>::extractMin() {
+template <typename T, template <typename> class Allocator>
+typename FibonacciHeap<T, Allocator>::Element
+FibonacciHeap<T, Allocator>::extractMin() {
   // segfaults if empty
-  Entry *min = mMin;
+  Element result = removeRoot(mMin);
+  // if min was the last node, no merging should occur
+  if (mMin) consolidate();
+  return result;
+}
+
+template <typename T, template <typename> class Allocator>
+std::vector<typename FibonacciHeap<T, Allocator>::Element>
+FibonacciHeap<T, Allocator>::extractMinBatch(size_t count) {
+  std::vector<Element> result;
+  if (count > mSize) count = mSize;
+  if (count == 0) return result;
+  result.reserve(count);
+
+  // the next smallest is always a root, or the child of one taken already,
+  // so a binary heap of the roots that gains each taken root's children
+  // hands them out in order without touching the root list in between
+  mBatch.clear();
+  Entry *first = mMin;
+  Entry *cur = first;
+  do {
+    mBatch.push_back(std::make_pair(cur->getPriority(), cur));
+    cur = cur->mNext;
+  } while (cur != first);
+  std::make_heap(mBatch.begin(), mBatch.end(), later);
+
+  while (result.size() < count) {
+    std::pop_heap(mBatch.begin(), mBatch.end(), later);
+    Entry *min = mBatch.back().second;
+    mBatch.pop_back();
+    // the children of the last one taken can't be taken in this batch
+    Entry *child = result.size() + 1 < count ? min->mChild : NULL;
+    if (child) {
+      cur = child;
+      do {
+        mBatch.push_back(std::make_pair(cur->getPriority(), cur));
+        std::push_heap(mBatch.begin(), mBatch.end(), later);
+        cur = cur->mNext;
+      } while (cur != child);
+    }
+    result.push_back(removeRoot(min));
+  }
+
+  if (mMin) consolidate();
+  return result;
+}
+
+template <typename T, template <typename> class Allocator>
+typename FibonacciHeap<T, Allocator>::Element
+FibonacciHeap<T, Allocator>::removeRoot(Entry *root) {
+  Element result(root->getValue(), root->getPriority());
 
-  // pull the min node out of the root list
-  if (mMin->mNext == mMin) {
+  // pull the node out of the root list
+  if (root->mNext == root) {
     mMin = NULL;
   } else {
-    mMin->mPrev->mNext = mMin->mNext;
-    mMin->mNext->mPrev = mMin->mPrev;
-    mMin = mMin->mNext;
+    root->mPrev->mNext = root->mNext;
+    root->mNext->mPrev = root->mPrev;
+    mMin = root->mNext;
   }
   mSize--;
 
-  // sever any children from the min node and promote them to the root list
-  Entry *firstChild = min->mChild;
+  // sever any children from the node and promote them to the root list
+  Entry *firstChild = root->mChild;
   if (firstChild) {
-    Entry *cur = firstChild->mNext;
+    Entry *cur = firstChild;
     do {
       cur->mParent = NULL;
-      cur = firstChild->mNext;
+      cur = cur->mNext;
     } while (cur != firstChild);
 
     if (mMin) {
       mergeLists(mMin, firstChild);
-      mMin = mMin->getPriority() <= firstChild->getPriority() 
-        ? mMin : firstChild;
     } else {
       mMin = firstChild;
     }
   }
 
-  // clean up the min node for deletion by user
-  min->mNext = min;
-  min->mPrev = min;
-  min->mChild = NULL;
-
-  // if min was the last node, no merging should occur
-  if (!mMin) {
-    return *min;
-  }
-
-  // create a vector with a bucket for trees of each degree
-  // and a vector to store the root nodes and make sure we visit them all
-  std::vector<Entry *> buckets;
-  std::vector<Entry *> toVisit;
-
-  Entry *first = mMin;
-  toVisit.push_back(first);
-  for (Entry *cur = first->mNext; cur != first; cur = cur->mNext) {
-    toVisit.push_back(cur);
-  }
+  // the node is done with, recycle it
+  root->~Entry();
+  mAllocator.deallocate(root);
+  return result;
+}
 
-  // put each root node (tree) into the appropriate bucket
-  // merge if necessary
-  for (typename std::vector<Entry *>::iterator it = toVisit.begin(); 
-      it != toVisit.end(); ++it) {
-    Entry *cur = *it;
+template <typename T, template <typename> class Allocator>
+void FibonacciHeap<T, Allocator>::consolidate() {
+  // walk the root list once, putting each root into the slot for its degree
+  // and merging when the slot is taken; linking only ever unlinks roots
+  // already visited or the current one, so the next root stays put
+  Entry *next = mMin;
+  Entry *last = mMin->mPrev;
+  size_t maxDegree = 0;
+  for (bool done = false; !done;) {
+    Entry *cur = next;
+    next = cur->mNext;
+    done = cur == last;
     for (;;) {
-      // extend the bucket list (vector really but where's the pun in that)
-      while (cur->getDegree() >= buckets.size()) {
-        buckets.push_back(NULL);
-      }
-      // if the bucket was empty, fill it
-      if (!buckets[cur->getDegree()]) {
-        buckets[cur->getDegree()] = cur;
+      size_t degree = cur->getDegree();
+      // if the slot was empty, fill it
+      if (!mDegrees[degree]) {
+        mDegrees[degree] = cur;
+        if (degree > maxDegree) maxDegree = degree;
         break;
       }
       // otherwise merge
-      Entry *other = buckets[cur->getDegree()];
-      buckets[cur->getDegree()] = NULL;
+      Entry *other = mDegrees[degree];
+      mDegrees[degree] = NULL;
 
-      Entry *greater = other->getDegree() < cur->getDegree() ? cur : other;
-      Entry *lesser = other->getDegree() < cur->getDegree() ? other : cur;
+      Entry *greater = other->getPriority() < cur->getPriority() ? cur : other;
+      Entry *lesser = other->getPriority() < cur->getPriority() ? other : cur;
       greater->mNext->mPrev = greater->mPrev;
       greater->mPrev->mNext = greater->mNext;
       greater->mPrev = greater->mNext = greater;
@@ -283,15 +386,28 @@ typename FibonacciHeap<T>::Entry& FibonacciHeap<T>::extractMin() {
       lesser->increaseDegree();
       cur = lesser;
     }
-    if (cur->getPriority() <= mMin->getPriority())
-      mMin = cur;
   }
 
-  return *min;
+  // what is left in the table is the root list, find its min and clear it
+  mMin = NULL;
+  for (size_t degree = 0; degree <= maxDegree; ++degree) {
+    Entry *root = mDegrees[degree];
+    if (!root) continue;
+    mDegrees[degree] = NULL;
+    if (!mMin || root->getPriority() <= mMin->getPriority()) mMin = root;
+  }
+}
+
+// the order for mBatch, which std's heap algorithms keep largest first
+template <typename T, template <typename> class Allocator>
+inline bool FibonacciHeap<T, Allocator>::later(
+    const std::pair<double, Entry *>& one,
+    const std::pair<double, Entry *>& two) {
+  return one.first > two.first;
 }
 
-template <typename T>
-void FibonacciHeap<T>::decreaseKey(Entry& entry, double newPriority) {
+template <typename T, template <typename> class Allocator>
+void FibonacciHeap<T, Allocator>::decreaseKey(Entry& entry, double newPriority) {
   entry.setPriority(newPriority);
 
   if (entry.mParent && entry.getPriority() <= entry.mParent->getPriority()) {
@@ -303,10 +419,10 @@ void FibonacciHeap<T>::decreaseKey(Entry& entry, double newPriority) {
   }
 }
 
-template <typename T>
-typename FibonacciHeap<T>::Entry& FibonacciHeap<T>::enqueue(const T& value, 
+template <typename T, template <typename> class Allocator>
+typename FibonacciHeap<T, Allocator>::Entry& FibonacciHeap<T, Allocator>::enqueue(const T& value, 
     const double priority) {
-  Entry *newEntry = new Entry(value, priority);
+  Entry *newEntry = new (mAllocator.allocate()) Entry(value, priority);
   mergeLists(newEntry, mMin);
   if (!mMin || newEntry->getPriority() < mMin->getPriority()) {
     mMin = newEntry;
@@ -315,8 +431,8 @@ typename FibonacciHeap<T>::Entry& FibonacciHeap<T>::enqueue(const T& value,
   return *newEntry;
 }
 
-template <typename T>
-void FibonacciHeap<T>::cutNode(Entry &entry) {
+template <typename T, template <typename> class Allocator>
+void FibonacciHeap<T, Allocator>::cutNode(Entry &entry) {
 
   entry.unmark();
   if (!entry.mParent) return;
@@ -326,7 +442,7 @@ void FibonacciHeap<T>::cutNode(Entry &entry) {
   if (entry.mNext != &entry) {
     entry.mPrev->mNext = entry.mNext;
     entry.mNext->mPrev = entry.mPrev;
-    entry.mParent->mChild = entry->mNext;
+    entry.mParent->mChild = entry.mNext;
   }
   if (entry.mParent->mChild == &entry) {
     entry.mParent->mChild = NULL;
@@ -336,21 +452,22 @@ void FibonacciHeap<T>::cutNode(Entry &entry) {
   // merge the node with the root list
   entry.mNext = entry.mPrev = &entry;
   mergeLists(mMin, &entry);
-  if (mMin->getPriority() < entry.getPriority()) {
+  if (entry.getPriority() < mMin->getPriority()) {
     mMin = &entry;
   }
 
   // recursively cut the parent if it was marked
-  if (entry.mParent->isMarked()) {
-    cutNode(*entry.mParent);
+  Entry *parent = entry.mParent;
+  entry.mParent = NULL;
+  if (parent->isMarked()) {
+    cutNode(*parent);
   } else {
-    entry.mParent->mark();
+    parent->mark();
   }
-  entry.mParent = NULL;
 }
 
-template <typename T>
-void FibonacciHeap<T>::mergeLists(Entry *one, Entry *two) {
+template <typename T, template <typename> class Allocator>
+void FibonacciHeap<T, Allocator>::mergeLists(Entry *one, Entry *two) {
   if (!one || !two) return;
 
   one->mPrev->mNext = two->mNext;
@@ -359,22 +476,29 @@ void FibonacciHeap<T>::mergeLists(Entry *one, Entry *two) {
   one->mPrev = two;
 }
 
-template <typename T>
-FibonacciHeap<T>& FibonacciHeap<T>::meld(FibonacciHeap<T>& first, 
-    FibonacciHeap<T>& second) {
+template <typename T, template <typename> class Allocator>
+FibonacciHeap<T, Allocator>& FibonacciHeap<T, Allocator>::meld(
+    FibonacciHeap<T, Allocator>& first, FibonacciHeap<T, Allocator>& second) {
 
-  FibonacciHeap<T> *result = new FibonacciHeap<T>();
-  Entry& minOne = first.findMin();
-  Entry& minTwo = second.findMin();
+  FibonacciHeap<T, Allocator> *result = new FibonacciHeap<T, Allocator>();
+  Entry *minOne = first.mMin;
+  Entry *minTwo = second.mMin;
 
   //merge the root lists of the two heaps
-  mergeLists(&minOne, &minTwo);
+  mergeLists(minOne, minTwo);
 
   //set min to the lower of the two and set size
-  result->setMin(minOne.getPriority() < minTwo.getPriority() 
-      ? &minOne : &minTwo);
+  if (!minOne || (minTwo && minTwo->getPriority() < minOne->getPriority())) {
+    result->setMin(minTwo);
+  } else {
+    result->setMin(minOne);
+  }
   result->setSize(first.getSize() + second.getSize());
 
+  //the entries now belong to the result, and so does their memory
+  result->mAllocator.absorb(first.mAllocator);
+  result->mAllocator.absorb(second.mAllocator);
+
   //empty out the old heaps
   first.setMin(NULL);
   second.setMin(NULL);
@@ -0,0 +1,123 @@
+/*
+ * Flat Disjoint Set
+ *
+ * Union-find over the dense ids [0, size()). Where DisjointSet is one
+ * heap allocated object per element, here the whole forest is a single
+ * contiguous uint32_t parent array plus a parallel array of set sizes,
+ * which is what the Kruskal and Boruvka inner loops want to stream over.
+ *
+ * find uses path halving (every visited node is pointed at its
+ * grandparent), unionSets links the smaller set under the larger one.
+ */
+
+#ifndef FlatDisjointSet_Included
+#define FlatDisjointSet_Included
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class FlatDisjointSet {
+  public:
+    FlatDisjointSet();
+    FlatDisjointSet(size_t size);
+    ~FlatDisjointSet();
+
+    inline size_t size() const;
+    inline size_t numSets() const;
+
+    inline uint32_t find(uint32_t id);
+    // returns the root of the merged set
+    inline uint32_t unionSets(uint32_t one, uint32_t two);
+    inline bool sameSet(uint32_t one, uint32_t two);
+    inline uint32_t setSize(uint32_t id);
+
+    // roots[i] = find(ids[i]) for a whole batch, prefetching ahead so the
+    // parent lookups of neighbouring ids overlap instead of serializing
+    void findBatch(const uint32_t *ids, size_t count, uint32_t *roots);
+
+    // every element back in its own singleton set
+    void reset();
+
+  private:
+    std::vector<uint32_t> mParent;
+    std::vector<uint32_t> mSize;
+    size_t mNumSets;
+};
+
+inline FlatDisjointSet::FlatDisjointSet() : mNumSets(0) {
+  // Handled in initializer list.
+}
+
+inline FlatDisjointSet::FlatDisjointSet(size_t size) :
+  mParent(size), mSize(size), mNumSets(size) {
+  reset();
+}
+
+inline FlatDisjointSet::~FlatDisjointSet() {
+  // Does nothing.
+}
+
+inline size_t FlatDisjointSet::size() const {
+  return mParent.size();
+}
+
+inline size_t FlatDisjointSet::numSets() const {
+  return mNumSets;
+}
+
+inline uint32_t FlatDisjointSet::find(uint32_t id) {
+  while (mParent[id] != id) {
+    mParent[id] = mParent[mParent[id]];
+    id = mParent[id];
+  }
+  return id;
+}
+
+inline uint32_t FlatDisjointSet::unionSets(uint32_t one, uint32_t two) {
+  uint32_t rootOne = find(one);
+  uint32_t rootTwo = find(two);
+  if (rootOne == rootTwo) {
+    return rootOne;
+  }
+  if (mSize[rootOne] < mSize[rootTwo]) {
+    uint32_t tmp = rootOne;
+    rootOne = rootTwo;
+    rootTwo = tmp;
+  }
+  mParent[rootTwo] = rootOne;
+  mSize[rootOne] += mSize[rootTwo];
+  mNumSets--;
+  return rootOne;
+}
+
+inline bool FlatDisjointSet::sameSet(uint32_t one, uint32_t two) {
+  return find(one) == find(two);
+}
+
+inline uint32_t FlatDisjointSet::setSize(uint32_t id) {
+  return mSize[find(id)];
+}
+
+inline void FlatDisjointSet::findBatch(const uint32_t *ids, size_t count,
+    uint32_t *roots) {
+  const size_t lookahead = 16;
+  for (size_t i = 0; i < count; ++i) {
+#if defined(__GNUC__)
+    if (i + lookahead < count) {
+      __builtin_prefetch(&mParent[ids[i + lookahead]]);
+    }
+#endif
+    roots[i] = find(ids[i]);
+  }
+}
+
+inline void FlatDisjointSet::reset() {
+  for (size_t i = 0; i < mParent.size(); ++i) {
+    mParent[i] = i;
+    mSize[i] = 1;
+  }
+  mNumSets = mParent.size();
+}
+
+#endif
@@ -0,0 +1,249 @@
+/*
+ * Flat Disjoint Set Forest
+ *
+ * The contractible graph behind Boruvka steps, KKT and soft heap MST,
+ * laid out for bulk work. The super nodes are numbered densely in
+ * [0, size()) and the edges between them are one flat array. Each edge
+ * remembers the index of the input edge it came from.
+ *
+ * contractEdges merges a whole batch of edges in one pass. It unions the
+ * batch in a FlatDisjointSet over the current super nodes, renumbers the
+ * resulting roots densely, and relabels every edge endpoint. Then it
+ * drops self loops and radix sorts the survivors by (first, second).
+ * Each run of parallel edges collapses to its lightest member. This
+ * replaces DisjointSetForest::contractEdge, which rebuilds a hash map
+ * per contracted edge.
+ */
+
+#ifndef FlatDisjointSetForest_Included
+#define FlatDisjointSetForest_Included
+
+#include "CSRGraph.hh"
+#include "FlatDisjointSet.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class FlatDisjointSetForest {
+  public:
+    struct Edge {
+      uint32_t first;
+      uint32_t second;
+      double weight;
+      size_t origin;
+    };
+
+    FlatDisjointSetForest();
+    // keeps the lightest of any parallel edges and drops self loops
+    FlatDisjointSetForest(size_t numVertices,
+                          const std::vector<CSRGraph::Edge>& edges);
+    // the same, for edges that already carry an origin
+    FlatDisjointSetForest(size_t numVertices, const std::vector<Edge>& edges);
+    ~FlatDisjointSetForest();
+
+    inline size_t size() const;
+    inline size_t numEdges() const;
+    inline bool isEmpty() const;
+    inline const std::vector<Edge>& getEdges() const;
+
+    // the super node that input vertex now belongs to
+    inline uint32_t superNodeOf(uint32_t vertex) const;
+    inline bool sameSuperNode(uint32_t first, uint32_t second) const;
+
+    // contracts the edges at the given positions of getEdges(); positions
+    // from before the call are invalidated
+    void contractEdges(const std::vector<size_t>& batch);
+    // contracts the lightest edge around every super node and appends the
+    // contracted edges to picked; lighter edges win ties by lower origin
+    void boruvkaStep(std::vector<Edge>& picked);
+
+  private:
+    size_t mSize;
+    std::vector<Edge> mEdges;
+    std::vector<uint32_t> mSuperNode;
+
+    void initialize(size_t numVertices);
+    // relabels every edge through label, drops self loops and keeps the
+    // lightest edge between each pair of super nodes
+    void relabel(const std::vector<uint32_t>& label);
+    static void radixSort(std::vector<Edge>& edges, size_t numNodes);
+    static inline bool lighter(const Edge& one, const Edge& two);
+};
+
+inline FlatDisjointSetForest::FlatDisjointSetForest() : mSize(0) {
+  // Handled in initializer list.
+}
+
+inline FlatDisjointSetForest::FlatDisjointSetForest(size_t numVertices,
+    const std::vector<CSRGraph::Edge>& edges) {
+  mEdges.reserve(edges.size());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    Edge edge = { edges[i].first, edges[i].second, edges[i].weight, i };
+    mEdges.push_back(edge);
+  }
+  initialize(numVertices);
+}
+
+inline FlatDisjointSetForest::FlatDisjointSetForest(size_t numVertices,
+    const std::vector<Edge>& edges) : mEdges(edges) {
+  initialize(numVertices);
+}
+
+inline void FlatDisjointSetForest::initialize(size_t numVertices) {
+  mSize = numVertices;
+  mSuperNode.resize(numVertices);
+  std::vector<uint32_t> identity(numVertices);
+  for (size_t v = 0; v < numVertices; ++v) {
+    identity[v] = v;
+    mSuperNode[v] = v;
+  }
+  relabel(identity);
+}
+
+inline FlatDisjointSetForest::~FlatDisjointSetForest() {
+  // Does nothing.
+}
+
+inline size_t FlatDisjointSetForest::size() const {
+  return mSize;
+}
+
+inline size_t FlatDisjointSetForest::numEdges() const {
+  return mEdges.size();
+}
+
+inline bool FlatDisjointSetForest::isEmpty() const {
+  return mSize == 0;
+}
+
+inline const std::vector<FlatDisjointSetForest::Edge>&
+FlatDisjointSetForest::getEdges() const {
+  return mEdges;
+}
+
+inline uint32_t FlatDisjointSetForest::superNodeOf(uint32_t vertex) const {
+  return mSuperNode[vertex];
+}
+
+inline bool FlatDisjointSetForest::sameSuperNode(uint32_t first,
+    uint32_t second) const {
+  return mSuperNode[first] == mSuperNode[second];
+}
+
+inline bool FlatDisjointSetForest::lighter(const Edge& one, const Edge& two) {
+  return one.weight < two.weight ||
+    (one.weight == two.weight && one.origin < two.origin);
+}
+
+inline void FlatDisjointSetForest::contractEdges(
+    const std::vector<size_t>& batch) {
+  FlatDisjointSet sets(mSize);
+  for (size_t i : batch) {
+    sets.unionSets(mEdges[i].first, mEdges[i].second);
+  }
+
+  // number the surviving roots densely, in order of their old ids
+  std::vector<uint32_t> label(mSize);
+  uint32_t numNodes = 0;
+  for (size_t v = 0; v < mSize; ++v) {
+    if (sets.find(v) == v) label[v] = numNodes++;
+  }
+  for (size_t v = 0; v < mSize; ++v) {
+    label[v] = label[sets.find(v)];
+  }
+  for (size_t v = 0; v < mSuperNode.size(); ++v) {
+    mSuperNode[v] = label[mSuperNode[v]];
+  }
+  mSize = numNodes;
+
+  relabel(label);
+}
+
+inline void FlatDisjointSetForest::boruvkaStep(std::vector<Edge>& picked) {
+  const size_t NONE = SIZE_MAX;
+  std::vector<size_t> cheapest(mSize, NONE);
+  for (size_t i = 0; i < mEdges.size(); ++i) {
+    const Edge& edge = mEdges[i];
+    if (cheapest[edge.first] == NONE ||
+        lighter(edge, mEdges[cheapest[edge.first]])) {
+      cheapest[edge.first] = i;
+    }
+    if (cheapest[edge.second] == NONE ||
+        lighter(edge, mEdges[cheapest[edge.second]])) {
+      cheapest[edge.second] = i;
+    }
+  }
+
+  // an edge that is the lightest for both of its endpoints shows up twice
+  std::vector<size_t> batch;
+  for (size_t v = 0; v < mSize; ++v) {
+    size_t i = cheapest[v];
+    if (i == NONE) continue;
+    const Edge& edge = mEdges[i];
+    uint32_t other = edge.first == v ? edge.second : edge.first;
+    if (other < v && cheapest[other] == i) continue;
+    batch.push_back(i);
+    picked.push_back(edge);
+  }
+  contractEdges(batch);
+}
+
+inline void FlatDisjointSetForest::relabel(const std::vector<uint32_t>& label) {
+  size_t kept = 0;
+  for (size_t i = 0; i < mEdges.size(); ++i) {
+    Edge edge = mEdges[i];
+    uint32_t first = label[edge.first];
+    uint32_t second = label[edge.second];
+    if (first == second) continue;
+    edge.first = first < second ? first : second;
+    edge.second = first < second ? second : first;
+    mEdges[kept++] = edge;
+  }
+  mEdges.resize(kept);
+
+  radixSort(mEdges, mSize);
+
+  // runs of equal endpoints are adjacent now, keep the lightest of each
+  kept = 0;
+  for (size_t i = 0; i < mEdges.size(); ++i) {
+    if (kept && mEdges[kept - 1].first == mEdges[i].first &&
+        mEdges[kept - 1].second == mEdges[i].second) {
+      if (lighter(mEdges[i], mEdges[kept - 1])) mEdges[kept - 1] = mEdges[i];
+    } else {
+      mEdges[kept++] = mEdges[i];
+    }
+  }
+  mEdges.resize(kept);
+  mEdges.shrink_to_fit();
+}
+
+// least significant digit radix sort on (first, second), 8 bits per pass,
+// skipping the high bytes that no node id below numNodes can have set
+inline void FlatDisjointSetForest::radixSort(std::vector<Edge>& edges,
+                                             size_t numNodes) {
+  size_t bytes = 0;
+  while (bytes < 4 && (numNodes - 1) >> (8 * bytes)) bytes++;
+  if (bytes == 0 || edges.size() < 2) return;
+
+  std::vector<Edge> scratch(edges.size());
+  for (size_t pass = 0; pass < 2 * bytes; ++pass) {
+    bool onSecond = pass < bytes;
+    size_t shift = 8 * (onSecond ? pass : pass - bytes);
+    size_t counts[257] = { 0 };
+    for (const Edge& edge : edges) {
+      uint32_t key = onSecond ? edge.second : edge.first;
+      counts[((key >> shift) & 0xFF) + 1]++;
+    }
+    for (size_t digit = 0; digit < 256; ++digit) {
+      counts[digit + 1] += counts[digit];
+    }
+    for (const Edge& edge : edges) {
+      uint32_t key = onSecond ? edge.second : edge.first;
+      scratch[counts[(key >> shift) & 0xFF]++] = edge;
+    }
+    edges.swap(scratch);
+  }
+}
+
+#endif
@@ -0,0 +1,208 @@
+/*
+ * Indexed Bucket Heap
+ *
+ * A bucket queue over the ids 0 to capacity - 1 for integer priorities,
+ * with the same interface as IndexedFibonacciHeap. There is a bucket per
+ * priority, a doubly linked list of the ids that have it, and over the
+ * buckets a tree of 64-bit words in which each bit says whether the bucket
+ * or word below it holds anything. findMin descends one word per level,
+ * which is three levels for priorities below 2^18, and enqueue,
+ * decreaseKey and extractMin touch one bucket and flip at most a bit per
+ * level.
+ *
+ * This is not a radix heap: that redistributes buckets around the last
+ * minimum and so needs priorities that never drop below it, which holds
+ * for Dijkstra but not for Prim. A bucket per priority drops that
+ * requirement at the cost of memory linear in the largest priority, which
+ * is fine for the small integer weights this heap is meant for. Buckets
+ * grow on demand, up to MAX_PRIORITY of them. Priorities must be integers
+ * in [0, MAX_PRIORITY); anything else throws std::invalid_argument, in
+ * release builds as well, since truncating it would give a wrong tree.
+ */
+
+#ifndef IndexedBucketHeap_Included
+#define IndexedBucketHeap_Included
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+class IndexedBucketHeap {
+  public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+    // 2^24 buckets take 64 MB, far more than integer weights need
+    static constexpr uint32_t MAX_PRIORITY = 1 << 24;
+
+    IndexedBucketHeap(size_t capacity);
+
+    inline size_t size() const;
+    inline bool isEmpty() const;
+    inline bool contains(uint32_t id) const;
+    inline double getPriority(uint32_t id) const;
+    inline uint32_t findMin() const;
+
+    inline void enqueue(uint32_t id, double priority);
+    inline uint32_t extractMin();
+    inline void decreaseKey(uint32_t id, double newPriority);
+
+  private:
+    // the mPrev of ids outside the heap, the first id of a bucket has NONE
+    static constexpr uint32_t OUT = NONE - 1;
+
+    struct Node {
+      uint32_t mPriority;
+      uint32_t mNext;
+      uint32_t mPrev;
+    };
+
+    std::vector<Node> mNodes;
+    // the first id of each bucket
+    std::vector<uint32_t> mBuckets;
+    // mLevels[0] has a bit per bucket, each level above a bit per word of
+    // the one below, and the last level is a single word
+    std::vector<std::vector<uint64_t> > mLevels;
+    size_t mSize;
+
+    // the bucket of priority, or std::invalid_argument if it has none
+    static inline uint32_t bucketOf(double priority);
+    inline void insert(uint32_t id, uint32_t priority);
+    inline void remove(uint32_t id);
+    // the lowest priority with a nonempty bucket, undefined if empty
+    inline uint32_t minPriority() const;
+    void grow(uint32_t priority);
+
+    IndexedBucketHeap(IndexedBucketHeap const &) = delete;
+    void operator=(IndexedBucketHeap const &) = delete;
+};
+
+inline IndexedBucketHeap::IndexedBucketHeap(size_t capacity) :
+  mNodes(capacity, Node { 0, NONE, OUT }), mBuckets(64, NONE),
+  mLevels(1, std::vector<uint64_t>(1, 0)), mSize(0) {
+  // Handled in initializer list.
+}
+
+inline size_t IndexedBucketHeap::size() const {
+  return mSize;
+}
+
+inline bool IndexedBucketHeap::isEmpty() const {
+  return mSize == 0;
+}
+
+inline bool IndexedBucketHeap::contains(uint32_t id) const {
+  return mNodes[id].mPrev != OUT;
+}
+
+inline double IndexedBucketHeap::getPriority(uint32_t id) const {
+  return mNodes[id].mPriority;
+}
+
+inline uint32_t IndexedBucketHeap::findMin() const {
+  return mSize == 0 ? NONE : mBuckets[minPriority()];
+}
+
+inline uint32_t IndexedBucketHeap::minPriority() const {
+  size_t index = 0;
+  for (size_t level = mLevels.size(); level-- > 0;) {
+    index = index * 64 + __builtin_ctzll(mLevels[level][index]);
+  }
+  return index;
+}
+
+inline void IndexedBucketHeap::insert(uint32_t id, uint32_t priority) {
+  if (priority >= mBuckets.size()) grow(priority);
+  Node& node = mNodes[id];
+  node.mPriority = priority;
+  node.mPrev = NONE;
+  node.mNext = mBuckets[priority];
+  mBuckets[priority] = id;
+  if (node.mNext != NONE) {
+    mNodes[node.mNext].mPrev = id;
+    return;
+  }
+
+  // the bucket was empty, set its bit and any word bits that were clear
+  size_t index = priority;
+  for (std::vector<uint64_t>& level : mLevels) {
+    uint64_t& word = level[index / 64];
+    bool wasEmpty = word == 0;
+    word |= uint64_t(1) << index % 64;
+    if (!wasEmpty) break;
+    index /= 64;
+  }
+}
+
+inline void IndexedBucketHeap::remove(uint32_t id) {
+  Node& node = mNodes[id];
+  if (node.mNext != NONE) mNodes[node.mNext].mPrev = node.mPrev;
+  if (node.mPrev != NONE) {
+    mNodes[node.mPrev].mNext = node.mNext;
+  } else {
+    mBuckets[node.mPriority] = node.mNext;
+  }
+  node.mPrev = OUT;
+  if (mBuckets[node.mPriority] != NONE) return;
+
+  // the bucket emptied, clear its bit and any words that emptied with it
+  size_t index = node.mPriority;
+  for (std::vector<uint64_t>& level : mLevels) {
+    uint64_t& word = level[index / 64];
+    word &= ~(uint64_t(1) << index % 64);
+    if (word != 0) break;
+    index /= 64;
+  }
+}
+
+inline void IndexedBucketHeap::grow(uint32_t priority) {
+  size_t buckets = mBuckets.size();
+  while (buckets <= priority) buckets *= 2;
+  mBuckets.resize(buckets, NONE);
+
+  // rebuild the levels over the new bucket count
+  mLevels.clear();
+  size_t words = buckets;
+  do {
+    words = (words + 63) / 64;
+    mLevels.push_back(std::vector<uint64_t>(words, 0));
+  } while (words > 1);
+  for (size_t i = 0; i < buckets; ++i) {
+    if (mBuckets[i] == NONE) continue;
+    size_t index = i;
+    for (std::vector<uint64_t>& level : mLevels) {
+      level[index / 64] |= uint64_t(1) << index % 64;
+      index /= 64;
+    }
+  }
+}
+
+inline uint32_t IndexedBucketHeap::bucketOf(double priority) {
+  // written so NaN fails too
+  if (!(priority >= 0 && priority < MAX_PRIORITY) ||
+      priority != (uint32_t) priority) {
+    throw std::invalid_argument(
+      "IndexedBucketHeap priorities must be integers in [0, MAX_PRIORITY)");
+  }
+  return (uint32_t) priority;
+}
+
+inline void IndexedBucketHeap::enqueue(uint32_t id, double priority) {
+  insert(id, bucketOf(priority));
+  mSize++;
+}
+
+inline uint32_t IndexedBucketHeap::extractMin() {
+  // undefined if empty
+  uint32_t min = mBuckets[minPriority()];
+  remove(min);
+  mSize--;
+  return min;
+}
+
+inline void IndexedBucketHeap::decreaseKey(uint32_t id, double newPriority) {
+  uint32_t bucket = bucketOf(newPriority);
+  remove(id);
+  insert(id, bucket);
+}
+
+#endif
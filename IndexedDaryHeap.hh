@@ -0,0 +1,142 @@
+/*
+ * Indexed D-ary Heap
+ *
+ * An implicit D-ary min-heap over the ids 0 to capacity - 1 with the same
+ * interface as IndexedFibonacciHeap, so Prim can take either. Each slot
+ * holds its priority next to its id, so sifting compares without leaving
+ * the heap array, and a position table indexed by id makes decreaseKey a
+ * sift up from where the id sits. With D = 4 the children of a slot share
+ * a cache line and the tree is half as deep as a binary heap.
+ */
+
+#ifndef IndexedDaryHeap_Included
+#define IndexedDaryHeap_Included
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+template <size_t D = 4>
+class IndexedDaryHeap {
+  public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    IndexedDaryHeap(size_t capacity);
+
+    inline size_t size() const;
+    inline bool isEmpty() const;
+    inline bool contains(uint32_t id) const;
+    // id must be in the heap
+    inline double getPriority(uint32_t id) const;
+    inline uint32_t findMin() const;
+
+    inline void enqueue(uint32_t id, double priority);
+    inline uint32_t extractMin();
+    inline void decreaseKey(uint32_t id, double newPriority);
+
+  private:
+    struct Slot {
+      double mPriority;
+      uint32_t mId;
+    };
+
+    std::vector<Slot> mHeap;
+    // where each id sits in mHeap, NONE for ids outside the heap
+    std::vector<uint32_t> mPosition;
+
+    inline void siftUp(size_t position, Slot slot);
+    inline void siftDown(size_t position, Slot slot);
+
+    IndexedDaryHeap(IndexedDaryHeap const &) = delete;
+    void operator=(IndexedDaryHeap const &) = delete;
+};
+
+template <size_t D>
+IndexedDaryHeap<D>::IndexedDaryHeap(size_t capacity) :
+  mPosition(capacity, NONE) {
+  mHeap.reserve(capacity);
+}
+
+template <size_t D>
+inline size_t IndexedDaryHeap<D>::size() const {
+  return mHeap.size();
+}
+
+template <size_t D>
+inline bool IndexedDaryHeap<D>::isEmpty() const {
+  return mHeap.empty();
+}
+
+template <size_t D>
+inline bool IndexedDaryHeap<D>::contains(uint32_t id) const {
+  return mPosition[id] != NONE;
+}
+
+template <size_t D>
+inline double IndexedDaryHeap<D>::getPriority(uint32_t id) const {
+  return mHeap[mPosition[id]].mPriority;
+}
+
+template <size_t D>
+inline uint32_t IndexedDaryHeap<D>::findMin() const {
+  return mHeap.empty() ? NONE : mHeap[0].mId;
+}
+
+template <size_t D>
+inline void IndexedDaryHeap<D>::enqueue(uint32_t id, double priority) {
+  mHeap.push_back(Slot { priority, id });
+  siftUp(mHeap.size() - 1, mHeap.back());
+}
+
+template <size_t D>
+inline uint32_t IndexedDaryHeap<D>::extractMin() {
+  // undefined if empty
+  uint32_t min = mHeap[0].mId;
+  mPosition[min] = NONE;
+  Slot last = mHeap.back();
+  mHeap.pop_back();
+  if (!mHeap.empty()) siftDown(0, last);
+  return min;
+}
+
+template <size_t D>
+inline void IndexedDaryHeap<D>::decreaseKey(uint32_t id, double newPriority) {
+  siftUp(mPosition[id], Slot { newPriority, id });
+}
+
+// moves the hole at position up past every heavier parent, then fills it
+template <size_t D>
+inline void IndexedDaryHeap<D>::siftUp(size_t position, Slot slot) {
+  while (position > 0) {
+    size_t parent = (position - 1) / D;
+    if (!(slot.mPriority < mHeap[parent].mPriority)) break;
+    mHeap[position] = mHeap[parent];
+    mPosition[mHeap[position].mId] = position;
+    position = parent;
+  }
+  mHeap[position] = slot;
+  mPosition[slot.mId] = position;
+}
+
+// moves the hole at position down past every lighter child, then fills it
+template <size_t D>
+inline void IndexedDaryHeap<D>::siftDown(size_t position, Slot slot) {
+  size_t size = mHeap.size();
+  for (;;) {
+    size_t first = position * D + 1;
+    if (first >= size) break;
+    size_t last = first + D < size ? first + D : size;
+    size_t best = first;
+    for (size_t child = first + 1; child < last; ++child) {
+      if (mHeap[child].mPriority < mHeap[best].mPriority) best = child;
+    }
+    if (!(mHeap[best].mPriority < slot.mPriority)) break;
+    mHeap[position] = mHeap[best];
+    mPosition[mHeap[position].mId] = position;
+    position = best;
+  }
+  mHeap[position] = slot;
+  mPosition[slot.mId] = position;
+}
+
+#endif
@@ -0,0 +1,262 @@
+/*
+ * Indexed Fibonacci Heap
+ *
+ * A Fibonacci heap over the ids 0 to capacity - 1, such as vertex ids,
+ * where each id is its own node. Nodes sit in one array indexed by id with
+ * 32-bit parent, child and sibling links, and the mark bit rides in the top
+ * bit of the degree byte, so a node is 32 bytes against the 56 or more of a
+ * FibonacciHeap::Entry and nothing is allocated per operation. The fields
+ * of a node share a record rather than parallel arrays because Prim visits
+ * ids in no particular order, and one record is one cache line to miss.
+ * decreaseKey takes the id itself, which spares callers a table of handles.
+ */
+
+#ifndef IndexedFibonacciHeap_Included
+#define IndexedFibonacciHeap_Included
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class IndexedFibonacciHeap {
+  public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    IndexedFibonacciHeap(size_t capacity);
+
+    inline size_t size() const;
+    inline bool isEmpty() const;
+    // whether id is in the heap right now
+    inline bool contains(uint32_t id) const;
+    inline double getPriority(uint32_t id) const;
+    inline uint32_t findMin() const;
+
+    // id must not be in the heap; it may have been extracted before
+    void enqueue(uint32_t id, double priority);
+    // returns the id with the lowest priority, which leaves the heap
+    uint32_t extractMin();
+    // id must be in the heap and newPriority no higher than its priority
+    void decreaseKey(uint32_t id, double newPriority);
+
+  private:
+    static constexpr uint8_t MARK = 0x80;
+    static constexpr size_t MAX_DEGREE = 64;
+
+    // mNext is NONE for ids outside the heap, the lists are circular
+    struct Node {
+      double mPriority;
+      uint32_t mParent;
+      uint32_t mChild;
+      uint32_t mNext;
+      uint32_t mPrev;
+      uint8_t mDegree;
+    };
+
+    std::vector<Node> mNodes;
+    std::vector<uint32_t> mRoots;
+    uint32_t mMin;
+    size_t mSize;
+
+    inline uint8_t degree(uint32_t id) const;
+    inline bool isMarked(uint32_t id) const;
+    inline void unlink(uint32_t id);
+    // splices the circular list holding two into the one holding one
+    inline void mergeLists(uint32_t one, uint32_t two);
+    void cutNode(uint32_t id);
+
+    IndexedFibonacciHeap(IndexedFibonacciHeap const &) = delete;
+    void operator=(IndexedFibonacciHeap const &) = delete;
+};
+
+inline IndexedFibonacciHeap::IndexedFibonacciHeap(size_t capacity) :
+  mNodes(capacity, Node { 0, NONE, NONE, NONE, NONE, 0 }), mMin(NONE),
+  mSize(0) {
+  // Handled in initializer list.
+}
+
+inline size_t IndexedFibonacciHeap::size() const {
+  return mSize;
+}
+
+inline bool IndexedFibonacciHeap::isEmpty() const {
+  return mSize == 0;
+}
+
+inline bool IndexedFibonacciHeap::contains(uint32_t id) const {
+  return mNodes[id].mNext != NONE;
+}
+
+inline double IndexedFibonacciHeap::getPriority(uint32_t id) const {
+  return mNodes[id].mPriority;
+}
+
+inline uint32_t IndexedFibonacciHeap::findMin() const {
+  // NONE if empty
+  return mMin;
+}
+
+inline uint8_t IndexedFibonacciHeap::degree(uint32_t id) const {
+  return mNodes[id].mDegree & ~MARK;
+}
+
+inline bool IndexedFibonacciHeap::isMarked(uint32_t id) const {
+  return mNodes[id].mDegree & MARK;
+}
+
+inline void IndexedFibonacciHeap::unlink(uint32_t id) {
+  mNodes[mNodes[id].mPrev].mNext = mNodes[id].mNext;
+  mNodes[mNodes[id].mNext].mPrev = mNodes[id].mPrev;
+  mNodes[id].mNext = mNodes[id].mPrev = id;
+}
+
+inline void IndexedFibonacciHeap::mergeLists(uint32_t one, uint32_t two) {
+  if (one == NONE || two == NONE) return;
+
+  mNodes[mNodes[one].mPrev].mNext = mNodes[two].mNext;
+  mNodes[mNodes[two].mNext].mPrev = mNodes[one].mPrev;
+  mNodes[two].mNext = one;
+  mNodes[one].mPrev = two;
+}
+
+inline void IndexedFibonacciHeap::enqueue(uint32_t id, double priority) {
+  mNodes[id].mPriority = priority;
+  mNodes[id].mParent = NONE;
+  mNodes[id].mChild = NONE;
+  mNodes[id].mNext = mNodes[id].mPrev = id;
+  mNodes[id].mDegree = 0;
+  mergeLists(id, mMin);
+  if (mMin == NONE || priority < mNodes[mMin].mPriority) {
+    mMin = id;
+  }
+  mSize++;
+}
+
+inline uint32_t IndexedFibonacciHeap::extractMin() {
+  // undefined if empty
+  uint32_t min = mMin;
+
+  // pull the min node out of the root list
+  if (mNodes[min].mNext == min) {
+    mMin = NONE;
+  } else {
+    mMin = mNodes[min].mNext;
+    unlink(min);
+  }
+  mSize--;
+
+  // promote the children to the root list
+  uint32_t firstChild = mNodes[min].mChild;
+  if (firstChild != NONE) {
+    uint32_t cur = firstChild;
+    do {
+      mNodes[cur].mParent = NONE;
+      cur = mNodes[cur].mNext;
+    } while (cur != firstChild);
+
+    if (mMin != NONE) {
+      mergeLists(mMin, firstChild);
+    } else {
+      mMin = firstChild;
+    }
+  }
+  mNodes[min].mNext = mNodes[min].mPrev = NONE;
+  mNodes[min].mChild = NONE;
+
+  if (mMin == NONE) return min;
+
+  // the root list changes while merging, so walk a copy of it
+  mRoots.clear();
+  uint32_t first = mMin;
+  uint32_t cur = first;
+  do {
+    mRoots.push_back(cur);
+    cur = mNodes[cur].mNext;
+  } while (cur != first);
+
+  // link roots of equal degree until every degree has at most one root
+  uint32_t buckets[MAX_DEGREE];
+  for (size_t i = 0; i < MAX_DEGREE; ++i) buckets[i] = NONE;
+  for (uint32_t root : mRoots) {
+    cur = root;
+    for (;;) {
+      uint8_t d = degree(cur);
+      if (buckets[d] == NONE) {
+        buckets[d] = cur;
+        break;
+      }
+      uint32_t other = buckets[d];
+      buckets[d] = NONE;
+
+      bool otherLess = mNodes[other].mPriority < mNodes[cur].mPriority;
+      uint32_t greater = otherLess ? cur : other;
+      uint32_t lesser = otherLess ? other : cur;
+      unlink(greater);
+      if (mNodes[lesser].mChild != NONE) {
+        mergeLists(mNodes[lesser].mChild, greater);
+      } else {
+        mNodes[lesser].mChild = greater;
+      }
+      mNodes[greater].mParent = lesser;
+      // greater is unmarked with the degree it had, lesser keeps its mark
+      mNodes[greater].mDegree = d;
+      mNodes[lesser].mDegree++;
+      cur = lesser;
+    }
+  }
+
+  // the new min is among the surviving roots
+  mMin = NONE;
+  for (size_t i = 0; i < MAX_DEGREE; ++i) {
+    if (buckets[i] == NONE) continue;
+    if (mMin == NONE ||
+        mNodes[buckets[i]].mPriority <= mNodes[mMin].mPriority) {
+      mMin = buckets[i];
+    }
+  }
+  return min;
+}
+
+inline void IndexedFibonacciHeap::decreaseKey(uint32_t id,
+                                              double newPriority) {
+  mNodes[id].mPriority = newPriority;
+
+  uint32_t parent = mNodes[id].mParent;
+  if (parent != NONE && newPriority <= mNodes[parent].mPriority) {
+    cutNode(id);
+  }
+
+  if (newPriority <= mNodes[mMin].mPriority) {
+    mMin = id;
+  }
+}
+
+inline void IndexedFibonacciHeap::cutNode(uint32_t id) {
+  // iterative form of the recursive cascading cut
+  for (;;) {
+    mNodes[id].mDegree &= ~MARK;
+    uint32_t parent = mNodes[id].mParent;
+    if (parent == NONE) return;
+
+    // point the parent past id before pulling it out of the siblings
+    if (mNodes[parent].mChild == id) {
+      mNodes[parent].mChild = mNodes[id].mNext == id ? NONE : mNodes[id].mNext;
+    }
+    unlink(id);
+    mNodes[parent].mDegree--;
+
+    mergeLists(mMin, id);
+    if (mNodes[id].mPriority < mNodes[mMin].mPriority) {
+      mMin = id;
+    }
+    mNodes[id].mParent = NONE;
+
+    if (!isMarked(parent)) {
+      // roots are never marked, a cut below them costs nothing
+      if (mNodes[parent].mParent != NONE) mNodes[parent].mDegree |= MARK;
+      return;
+    }
+    id = parent;
+  }
+}
+
+#endif
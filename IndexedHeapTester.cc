@@ -0,0 +1,125 @@
+#include "IndexedFibonacciHeap.hh"
+#include "IndexedDaryHeap.hh"
+#include "IndexedPairingHeap.hh"
+#include "IndexedBucketHeap.hh"
+#include "LazyHeap.hh"
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// every heap has the same interface, priorities here are small integers so
+// the bucket heap can take them too
+template <typename Heap>
+void testHeap() {
+  Heap heap(200);
+  assert(heap.isEmpty());
+  for (uint32_t i = 0; i < 200; i++) {
+    heap.enqueue(i, i + 1);
+    assert(heap.size() == i + 1);
+  }
+  assert(heap.extractMin() == 0);
+  assert(!heap.contains(0));
+  assert(heap.findMin() == 1);
+  heap.decreaseKey(150, 0);
+  assert(heap.findMin() == 150);
+  assert(heap.extractMin() == 150);
+  assert(heap.extractMin() == 1);
+  // an extracted id can come back
+  heap.enqueue(0, 1);
+  assert(heap.extractMin() == 0);
+  for (uint32_t i = 2; i < 200; i++) {
+    if (i == 150) continue;
+    assert(heap.extractMin() == i);
+  }
+  assert(heap.isEmpty());
+  assert(heap.findMin() == Heap::NONE);
+
+  // random operations against an ordered set of (priority, id), with
+  // plenty of decreaseKeys to exercise the cuts
+  const uint32_t capacity = 1000;
+  std::mt19937 rng(13);
+  Heap random(capacity);
+  std::vector<double> priority(capacity);
+  std::set<std::pair<double, uint32_t> > reference;
+  for (int round = 0; round < 200000; round++) {
+    uint32_t id = rng() % capacity;
+    int op = rng() % 8;
+    if (op == 0 && !reference.empty()) {
+      uint32_t min = random.findMin();
+      assert(random.getPriority(min) == reference.begin()->first);
+      assert(random.extractMin() == min);
+      assert(!random.contains(min));
+      assert(reference.erase(std::make_pair(priority[min], min)) == 1);
+    } else if (random.contains(id)) {
+      double newPriority = priority[id] - (rng() % 50);
+      if (newPriority < 0) newPriority = 0;
+      reference.erase(std::make_pair(priority[id], id));
+      reference.insert(std::make_pair(newPriority, id));
+      priority[id] = newPriority;
+      random.decreaseKey(id, newPriority);
+      assert(random.getPriority(id) == newPriority);
+    } else {
+      priority[id] = rng() % 100000;
+      reference.insert(std::make_pair(priority[id], id));
+      random.enqueue(id, priority[id]);
+    }
+    assert(random.size() == reference.size());
+    if (!reference.empty()) {
+      assert(random.getPriority(random.findMin()) == reference.begin()->first);
+    }
+  }
+  while (!random.isEmpty()) {
+    assert(random.getPriority(random.findMin()) == reference.begin()->first);
+    random.extractMin();
+    reference.erase(reference.begin());
+  }
+}
+
+int main() {
+  testHeap<IndexedFibonacciHeap>();
+  testHeap<IndexedDaryHeap<4> >();
+  testHeap<IndexedDaryHeap<2> >();
+  testHeap<IndexedPairingHeap>();
+  testHeap<IndexedBucketHeap>();
+  testHeap<LazyHeap>();
+
+  // the bucket heap refuses what it can't bucket, in release builds too,
+  // and a refused decreaseKey leaves the id where it was
+  IndexedBucketHeap buckets(2);
+  buckets.enqueue(0, 7);
+  for (double bad : { 1.5, -1.0, (double) IndexedBucketHeap::MAX_PRIORITY }) {
+    bool thrown = false;
+    try {
+      buckets.enqueue(1, bad);
+    } catch (const std::invalid_argument&) {
+      thrown = true;
+    }
+    assert(thrown && !buckets.contains(1));
+    thrown = false;
+    try {
+      buckets.decreaseKey(0, bad);
+    } catch (const std::invalid_argument&) {
+      thrown = true;
+    }
+    assert(thrown && buckets.getPriority(0) == 7);
+  }
+  assert(buckets.extractMin() == 0 && buckets.isEmpty());
+
+  // stale pairs stay in the lazy heap until they surface
+  LazyHeap lazy(3);
+  lazy.enqueue(0, 5);
+  lazy.enqueue(1, 6);
+  lazy.decreaseKey(1, 4);
+  lazy.decreaseKey(1, 3);
+  assert(lazy.size() == 2);
+  assert(lazy.numPairs() == 4);
+  assert(lazy.extractMin() == 1);
+  assert(lazy.extractMin() == 0);
+  assert(lazy.isEmpty());
+  assert(lazy.numPairs() == 0);
+  return 0;
+}
@@ -0,0 +1,158 @@
+/*
+ * Indexed Pairing Heap
+ *
+ * A pairing heap over the ids 0 to capacity - 1 with the same interface as
+ * IndexedFibonacciHeap. Each id is a 24 byte node: its priority, its first
+ * child, its next sibling and a back link that is the previous sibling or,
+ * for a first child, the parent. decreaseKey cuts the node out and links
+ * it with the root, and extractMin pairs up the root's children left to
+ * right and then folds the pairs right to left.
+ */
+
+#ifndef IndexedPairingHeap_Included
+#define IndexedPairingHeap_Included
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class IndexedPairingHeap {
+  public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    IndexedPairingHeap(size_t capacity);
+
+    inline size_t size() const;
+    inline bool isEmpty() const;
+    inline bool contains(uint32_t id) const;
+    inline double getPriority(uint32_t id) const;
+    inline uint32_t findMin() const;
+
+    inline void enqueue(uint32_t id, double priority);
+    inline uint32_t extractMin();
+    inline void decreaseKey(uint32_t id, double newPriority);
+
+  private:
+    // the back link of ids outside the heap, the root's is NONE
+    static constexpr uint32_t OUT = NONE - 1;
+
+    struct Node {
+      double mPriority;
+      uint32_t mChild;
+      uint32_t mNext;
+      uint32_t mPrev;
+    };
+
+    std::vector<Node> mNodes;
+    std::vector<uint32_t> mChildren;
+    uint32_t mRoot;
+    size_t mSize;
+
+    // makes the heavier of two roots the first child of the other
+    inline uint32_t link(uint32_t one, uint32_t two);
+
+    IndexedPairingHeap(IndexedPairingHeap const &) = delete;
+    void operator=(IndexedPairingHeap const &) = delete;
+};
+
+inline IndexedPairingHeap::IndexedPairingHeap(size_t capacity) :
+  mNodes(capacity, Node { 0, NONE, NONE, OUT }), mRoot(NONE), mSize(0) {
+  // Handled in initializer list.
+}
+
+inline size_t IndexedPairingHeap::size() const {
+  return mSize;
+}
+
+inline bool IndexedPairingHeap::isEmpty() const {
+  return mSize == 0;
+}
+
+inline bool IndexedPairingHeap::contains(uint32_t id) const {
+  return mNodes[id].mPrev != OUT;
+}
+
+inline double IndexedPairingHeap::getPriority(uint32_t id) const {
+  return mNodes[id].mPriority;
+}
+
+inline uint32_t IndexedPairingHeap::findMin() const {
+  return mRoot;
+}
+
+inline uint32_t IndexedPairingHeap::link(uint32_t one, uint32_t two) {
+  if (mNodes[two].mPriority < mNodes[one].mPriority) {
+    uint32_t tmp = one;
+    one = two;
+    two = tmp;
+  }
+  Node& parent = mNodes[one];
+  Node& child = mNodes[two];
+  child.mNext = parent.mChild;
+  if (parent.mChild != NONE) mNodes[parent.mChild].mPrev = two;
+  child.mPrev = one;
+  parent.mChild = two;
+  return one;
+}
+
+inline void IndexedPairingHeap::enqueue(uint32_t id, double priority) {
+  mNodes[id] = Node { priority, NONE, NONE, NONE };
+  mRoot = mRoot == NONE ? id : link(mRoot, id);
+  mNodes[mRoot].mPrev = NONE;
+  mSize++;
+}
+
+inline void IndexedPairingHeap::decreaseKey(uint32_t id, double newPriority) {
+  Node& node = mNodes[id];
+  node.mPriority = newPriority;
+  if (id == mRoot) return;
+
+  // cut the subtree out of its sibling list and link it with the root
+  Node& prev = mNodes[node.mPrev];
+  if (prev.mChild == id) {
+    prev.mChild = node.mNext;
+  } else {
+    prev.mNext = node.mNext;
+  }
+  if (node.mNext != NONE) mNodes[node.mNext].mPrev = node.mPrev;
+  node.mNext = NONE;
+  mRoot = link(mRoot, id);
+  mNodes[mRoot].mPrev = NONE;
+}
+
+inline uint32_t IndexedPairingHeap::extractMin() {
+  // undefined if empty
+  uint32_t min = mRoot;
+  mSize--;
+
+  // first pass links neighbouring children, left to right
+  mChildren.clear();
+  uint32_t child = mNodes[min].mChild;
+  while (child != NONE) {
+    uint32_t second = mNodes[child].mNext;
+    if (second == NONE) {
+      mChildren.push_back(child);
+      break;
+    }
+    uint32_t rest = mNodes[second].mNext;
+    mNodes[child].mNext = mNodes[second].mNext = NONE;
+    mChildren.push_back(link(child, second));
+    child = rest;
+  }
+
+  // second pass folds the pairs into one tree, right to left
+  mRoot = NONE;
+  for (size_t i = mChildren.size(); i-- > 0;) {
+    mRoot = mRoot == NONE ? mChildren[i] : link(mChildren[i], mRoot);
+  }
+  if (mRoot != NONE) {
+    mNodes[mRoot].mNext = NONE;
+    mNodes[mRoot].mPrev = NONE;
+  }
+
+  mNodes[min].mChild = NONE;
+  mNodes[min].mPrev = OUT;
+  return min;
+}
+
+#endif
@@ -0,0 +1,91 @@
+/*
+ * Interned Graph
+ *
+ * Loads an UndirectedGraph<T> once into a CSRGraph over dense vertex ids,
+ * remembering the key of every id in a VertexInterner. The id-based MST
+ * engines run on getGraph() and their edge lists are translated back into
+ * an UndirectedGraph<T> only when the result is emitted.
+ */
+
+#ifndef InternedGraph_Included
+#define InternedGraph_Included
+
+#include "UndirectedGraph.hh"
+#include "CSRGraph.hh"
+#include "VertexInterner.hh"
+
+#include <vector>
+
+template <typename T>
+class InternedGraph {
+  public:
+    InternedGraph(const UndirectedGraph<T>& graph);
+    ~InternedGraph();
+
+    inline const CSRGraph& getGraph() const;
+    inline const VertexInterner<T>& getVertices() const;
+
+    // every vertex of the original graph plus the given id edges
+    UndirectedGraph<T> translate(const std::vector<CSRGraph::Edge>& edges)
+      const;
+
+  private:
+    VertexInterner<T> mVertices;
+    CSRGraph mGraph;
+
+    InternedGraph(InternedGraph const &) = delete;
+    void operator=(InternedGraph const &) = delete;
+};
+
+template <typename T>
+InternedGraph<T>::InternedGraph(const UndirectedGraph<T>& graph) :
+  mVertices(graph.size()) {
+  for (const auto& node : graph) {
+    mVertices.intern(node.first);
+  }
+
+  // every edge appears in the adjacency of both endpoints, keep one copy
+  std::vector<CSRGraph::Edge> edges;
+  for (const auto& node : graph) {
+    uint32_t first = mVertices.find(node.first);
+    for (const auto& edge : node.second) {
+      uint32_t second = mVertices.find(edge.first);
+      if (first < second) {
+        CSRGraph::Edge idEdge = { first, second, edge.second };
+        edges.push_back(idEdge);
+      }
+    }
+  }
+  mGraph = CSRGraph(mVertices.size(), edges);
+}
+
+template <typename T>
+InternedGraph<T>::~InternedGraph() {
+  // Does nothing.
+}
+
+template <typename T>
+inline const CSRGraph& InternedGraph<T>::getGraph() const {
+  return mGraph;
+}
+
+template <typename T>
+inline const VertexInterner<T>& InternedGraph<T>::getVertices() const {
+  return mVertices;
+}
+
+template <typename T>
+UndirectedGraph<T> InternedGraph<T>::translate(
+    const std::vector<CSRGraph::Edge>& edges) const {
+  UndirectedGraph<T> result;
+  for (uint32_t id = 0; id < mVertices.size(); ++id) {
+    result.addNode(mVertices.valueOf(id));
+  }
+  for (const CSRGraph::Edge& edge : edges) {
+    result.addEdge(mVertices.valueOf(edge.first),
+                   mVertices.valueOf(edge.second), edge.weight);
+  }
+  return result;
+}
+
+#endif
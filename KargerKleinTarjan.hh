@@ -0,0 +1,166 @@
+/*
+ * Karger-Klein-Tarjan
+ *
+ * Randomized minimum spanning forest after Karger, Klein and Tarjan. Each
+ * call
+ *
+ *  1. runs two Boruvka steps on a FlatDisjointSetForest. The contracted
+ *     edges are in the forest and the vertex count drops by at least 4x.
+ *  2. samples every remaining edge with probability 1/2 and recursively
+ *     computes the minimum spanning forest F of the sample,
+ *  3. discards every F-heavy edge, which can't be in the MST. In
+ *     expectation at most 2n' edges survive,
+ *  4. recurses on the survivors.
+ *
+ * Small subproblems are finished with a sort and a union-find. Edges are
+ * ordered by (weight, input position) throughout, so the forest is the
+ * same unique one Kruskal and Prim find on distinct weights.
+ *
+ * KKT's expected O(m) bound needs a linear time F-heavy filter. Step 3 uses
+ * MSTVerifier, which takes O(m alpha(m, n) + n log n), so this runs in
+ * expected O(m alpha(m, n) + n log n) time.
+ */
+
+#ifndef KargerKleinTarjan_Included
+#define KargerKleinTarjan_Included
+
+#include "UndirectedGraph.hh"
+#include "CSRGraph.hh"
+#include "InternedGraph.hh"
+#include "FlatDisjointSet.hh"
+#include "FlatDisjointSetForest.hh"
+#include "MSTVerifier.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+template <typename T>
+class KargerKleinTarjan {
+  public:
+    static UndirectedGraph<T> mst(const UndirectedGraph<T>& graph);
+    static std::vector<CSRGraph::Edge> mst(const CSRGraph& graph);
+    static std::vector<CSRGraph::Edge> mst(size_t numVertices,
+        const std::vector<CSRGraph::Edge>& edges);
+
+  private:
+    typedef FlatDisjointSetForest::Edge Edge;
+
+    // appends the minimum spanning forest of edges to result; only the
+    // origins of the appended edges are meaningful to the caller, position
+    // is scratch space indexed by origin
+    static void msf(size_t numVertices, const std::vector<Edge>& edges,
+                    std::vector<Edge>& result, std::vector<size_t>& position,
+                    std::mt19937_64& rng);
+    static void kruskal(size_t numVertices, std::vector<Edge> edges,
+                        std::vector<Edge>& result);
+    static inline bool lighter(const Edge& one, const Edge& two);
+};
+
+template <typename T>
+UndirectedGraph<T> KargerKleinTarjan<T>::mst(const UndirectedGraph<T>& graph) {
+  InternedGraph<T> interned(graph);
+  return interned.translate(mst(interned.getGraph()));
+}
+
+template <typename T>
+std::vector<CSRGraph::Edge> KargerKleinTarjan<T>::mst(const CSRGraph& graph) {
+  return mst(graph.size(), graph.edgeList());
+}
+
+template <typename T>
+std::vector<CSRGraph::Edge> KargerKleinTarjan<T>::mst(size_t numVertices,
+    const std::vector<CSRGraph::Edge>& edges) {
+  std::vector<Edge> tagged;
+  tagged.reserve(edges.size());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    Edge edge = { edges[i].first, edges[i].second, edges[i].weight, i };
+    tagged.push_back(edge);
+  }
+
+  std::vector<Edge> forest;
+  std::vector<size_t> position(edges.size());
+  std::mt19937_64 rng(numVertices ^ edges.size());
+  msf(numVertices, tagged, forest, position, rng);
+
+  std::vector<CSRGraph::Edge> result;
+  result.reserve(forest.size());
+  for (const Edge& edge : forest) {
+    result.push_back(edges[edge.origin]);
+  }
+  return result;
+}
+
+template <typename T>
+inline bool KargerKleinTarjan<T>::lighter(const Edge& one, const Edge& two) {
+  return one.weight < two.weight ||
+    (one.weight == two.weight && one.origin < two.origin);
+}
+
+template <typename T>
+void KargerKleinTarjan<T>::kruskal(size_t numVertices, std::vector<Edge> edges,
+                                   std::vector<Edge>& result) {
+  std::sort(edges.begin(), edges.end(), lighter);
+  FlatDisjointSet sets(numVertices);
+  for (const Edge& edge : edges) {
+    if (sets.sameSet(edge.first, edge.second)) continue;
+    sets.unionSets(edge.first, edge.second);
+    result.push_back(edge);
+  }
+}
+
+template <typename T>
+void KargerKleinTarjan<T>::msf(size_t numVertices,
+                               const std::vector<Edge>& edges,
+                               std::vector<Edge>& result,
+                               std::vector<size_t>& position,
+                               std::mt19937_64& rng) {
+  const size_t baseCase = 1024;
+  if (edges.size() <= baseCase) {
+    kruskal(numVertices, edges, result);
+    return;
+  }
+
+  FlatDisjointSetForest forest(numVertices, edges);
+  for (int step = 0; step < 2 && forest.numEdges() > 0; ++step) {
+    forest.boruvkaStep(result);
+  }
+  if (forest.numEdges() == 0) return;
+
+  const std::vector<Edge>& contracted = forest.getEdges();
+  std::vector<Edge> sample;
+  sample.reserve(contracted.size() / 2 + 64);
+  uint64_t bits = 0;
+  for (size_t i = 0; i < contracted.size(); ++i) {
+    if (i % 64 == 0) bits = rng();
+    if (bits & 1) sample.push_back(contracted[i]);
+    bits >>= 1;
+  }
+
+  std::vector<Edge> sampleForest;
+  msf(forest.size(), sample, sampleForest, position, rng);
+
+  // sampleForest comes back in the recursion's endpoints; swap each edge
+  // for the sample edge with the same origin
+  for (size_t i = 0; i < sample.size(); ++i) {
+    position[sample[i].origin] = i;
+  }
+  for (Edge& edge : sampleForest) {
+    edge = sample[position[edge.origin]];
+  }
+  sample.clear();
+  sample.shrink_to_fit();
+
+  std::vector<uint8_t> heavy;
+  MSTVerifier(forest.size(), sampleForest).heavyEdges(contracted, heavy);
+  std::vector<Edge> light;
+  for (size_t i = 0; i < contracted.size(); ++i) {
+    if (!heavy[i]) light.push_back(contracted[i]);
+  }
+
+  msf(forest.size(), light, result, position, rng);
+}
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ * Kruskal and Filter-Kruskal
+ *
+ * mst sorts the whole edge list with Parallel::sort and scans it once,
+ * accepting every edge whose endpoints are still in different sets of a
+ * FlatDisjointSet.
+ *
+ * filterMst is Osipov, Sanders and Singler's Filter-Kruskal. It partitions
+ * the edges around a random pivot weight and solves the light half first.
+ * It then filters out every heavy edge whose endpoints the light half
+ * already connected, and only then recurses on what is left. Edges that
+ * can never enter the tree are dropped by a union-find lookup and are
+ * never sorted. Small subproblems fall back to plain Kruskal.
+ *
+ * Both return a minimum spanning forest, so disconnected inputs are fine.
+ */
+
+#ifndef Kruskal_Included
+#define Kruskal_Included
+
+#include "UndirectedGraph.hh"
+#include "CSRGraph.hh"
+#include "InternedGraph.hh"
+#include "FlatDisjointSet.hh"
+#include "Parallel.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+template <typename T>
+class Kruskal {
+  public:
+    // numThreads of 0 uses every hardware thread for the sort
+    static UndirectedGraph<T> mst(const UndirectedGraph<T>& graph,
+                                  size_t numThreads = 0);
+    static std::vector<CSRGraph::Edge> mst(const CSRGraph& graph,
+                                           size_t numThreads = 0);
+    static std::vector<CSRGraph::Edge> mst(size_t numVertices,
+        std::vector<CSRGraph::Edge> edges, size_t numThreads = 0);
+
+    static UndirectedGraph<T> filterMst(const UndirectedGraph<T>& graph,
+                                        size_t numThreads = 0);
+    static std::vector<CSRGraph::Edge> filterMst(const CSRGraph& graph,
+                                                 size_t numThreads = 0);
+    static std::vector<CSRGraph::Edge> filterMst(size_t numVertices,
+        std::vector<CSRGraph::Edge> edges, size_t numThreads = 0);
+
+  private:
+    typedef std::vector<CSRGraph::Edge>::iterator EdgeIterator;
+
+    static inline bool lighter(const CSRGraph::Edge& one,
+                               const CSRGraph::Edge& two);
+    static void sortAndScan(EdgeIterator begin, EdgeIterator end,
+                            FlatDisjointSet& sets,
+                            std::vector<CSRGraph::Edge>& result,
+                            size_t numThreads);
+    static void filterKruskal(EdgeIterator begin, EdgeIterator end,
+                              FlatDisjointSet& sets,
+                              std::vector<CSRGraph::Edge>& result,
+                              std::minstd_rand& rng, size_t numThreads);
+};
+
+template <typename T>
+UndirectedGraph<T> Kruskal<T>::mst(const UndirectedGraph<T>& graph,
+                                   size_t numThreads) {
+  InternedGraph<T> interned(graph);
+  return interned.translate(mst(interned.getGraph(), numThreads));
+}
+
+template <typename T>
+std::vector<CSRGraph::Edge> Kruskal<T>::mst(const CSRGraph& graph,
+                                            size_t numThreads) {
+  return mst(graph.size(), graph.edgeList(), numThreads);
+}
+
+template <typename T>
+std::vector<CSRGraph::Edge> Kruskal<T>::mst(size_t numVertices,
+    std::vector<CSRGraph::Edge> edges, size_t numThreads) {
+  FlatDisjointSet sets(numVertices);
+  std::vector<CSRGraph::Edge> result;
+  sortAndScan(edges.begin(), edges.end(), sets, result,
+              Parallel::numThreads(numThreads));
+  return result;
+}
+
+template <typename T>
+UndirectedGraph<T> Kruskal<T>::filterMst(const UndirectedGraph<T>& graph,
+                                         size_t numThreads) {
+  InternedGraph<T> interned(graph);
+  return interned.translate(filterMst(interned.getGraph(), numThreads));
+}
+
+template <typename T>
+std::vector<CSRGraph::Edge> Kruskal<T>::filterMst(const CSRGraph& graph,
+                                                  size_t numThreads) {
+  return filterMst(graph.size(), graph.edgeList(), numThreads);
+}
+
+template <typename T>
+std::vector<CSRGraph::Edge> Kruskal<T>::filterMst(size_t numVertices,
+    std::vector<CSRGraph::Edge> edges, size_t numThreads) {
+  FlatDisjointSet sets(numVertices);
+  std::vector<CSRGraph::Edge> result;
+  std::minstd_rand rng(numVertices + edges.size());
+  filterKruskal(edges.begin(), edges.end(), sets, result, rng,
+                Parallel::numThreads(numThreads));
+  return result;
+}
+
+template <typename T>
+inline bool Kruskal<T>::lighter(const CSRGraph::Edge& one,
+                                const CSRGraph::Edge& two) {
+  return one.weight < two.weight;
+}
+
+template <typename T>
+void Kruskal<T>::sortAndScan(EdgeIterator begin, EdgeIterator end,
+                             FlatDisjointSet& sets,
+                             std::vector<CSRGraph::Edge>& result,
+                             size_t numThreads) {
+  Parallel::sort(begin, end, lighter, numThreads);
+  for (EdgeIterator it = begin; it != end; ++it) {
+    if (sets.numSets() == 1) return;
+    if (sets.sameSet(it->first, it->second)) continue;
+    sets.unionSets(it->first, it->second);
+    result.push_back(*it);
+  }
+}
+
+template <typename T>
+void Kruskal<T>::filterKruskal(EdgeIterator begin, EdgeIterator end,
+                               FlatDisjointSet& sets,
+                               std::vector<CSRGraph::Edge>& result,
+                               std::minstd_rand& rng, size_t numThreads) {
+  const size_t baseCase = 4096;
+  if ((size_t) (end - begin) <= baseCase) {
+    sortAndScan(begin, end, sets, result, numThreads);
+    return;
+  }
+
+  double pivot = (begin + rng() % (end - begin))->weight;
+  EdgeIterator middle = std::partition(begin, end,
+    [pivot](const CSRGraph::Edge& edge) { return edge.weight <= pivot; });
+  // the pivot was the largest weight, so split off the edges equal to it
+  // instead; only if every weight equals it is there nothing to filter
+  if (middle == end) {
+    middle = std::partition(begin, end,
+      [pivot](const CSRGraph::Edge& edge) { return edge.weight < pivot; });
+    if (middle == begin) {
+      sortAndScan(begin, end, sets, result, numThreads);
+      return;
+    }
+  }
+
+  filterKruskal(begin, middle, sets, result, rng, numThreads);
+  if (sets.numSets() == 1) return;
+  EdgeIterator kept = std::partition(middle, end,
+    [&sets](const CSRGraph::Edge& edge) {
+      return !sets.sameSet(edge.first, edge.second);
+    });
+  filterKruskal(middle, kept, sets, result, rng, numThreads);
+}
+
+#endif
@@ -0,0 +1,157 @@
+/*
+ * Lazy Heap
+ *
+ * A flat 4-ary min-heap of (priority, id) pairs with the interface of
+ * IndexedFibonacciHeap, but without any handles: decreaseKey pushes a
+ * second, lighter pair for the id and leaves the old one where it is. A
+ * pair is stale once its id has left the heap or has a lighter pair, and
+ * stale pairs are dropped when they reach the top. All that is kept per id
+ * is its current priority and whether it is in the heap, so nothing moves
+ * when an id's priority drops, at the price of the heap growing up to one
+ * pair per decreaseKey. For Prim this is lazy deletion: the heap holds at
+ * most a pair per edge, and sparse graphs see few duplicates.
+ */
+
+#ifndef LazyHeap_Included
+#define LazyHeap_Included
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class LazyHeap {
+  public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    LazyHeap(size_t capacity);
+
+    inline size_t size() const;
+    inline bool isEmpty() const;
+    inline bool contains(uint32_t id) const;
+    inline double getPriority(uint32_t id) const;
+    inline uint32_t findMin() const;
+
+    inline void enqueue(uint32_t id, double priority);
+    inline uint32_t extractMin();
+    inline void decreaseKey(uint32_t id, double newPriority);
+
+    // the pairs in the heap, stale ones included
+    inline size_t numPairs() const;
+
+  private:
+    struct Slot {
+      double mPriority;
+      uint32_t mId;
+    };
+
+    std::vector<Slot> mHeap;
+    std::vector<double> mPriority;
+    std::vector<bool> mContains;
+    size_t mSize;
+
+    inline void push(uint32_t id, double priority);
+    // removes the top pair
+    inline void pop();
+    // pops pairs off the top until the top is current or the heap is empty
+    inline void dropStale();
+
+    LazyHeap(LazyHeap const &) = delete;
+    void operator=(LazyHeap const &) = delete;
+};
+
+inline LazyHeap::LazyHeap(size_t capacity) :
+  mPriority(capacity, 0), mContains(capacity, false), mSize(0) {
+  mHeap.reserve(capacity);
+}
+
+inline size_t LazyHeap::size() const {
+  return mSize;
+}
+
+inline bool LazyHeap::isEmpty() const {
+  return mSize == 0;
+}
+
+inline bool LazyHeap::contains(uint32_t id) const {
+  return mContains[id];
+}
+
+inline double LazyHeap::getPriority(uint32_t id) const {
+  return mPriority[id];
+}
+
+inline uint32_t LazyHeap::findMin() const {
+  // the top is never stale
+  return mSize == 0 ? NONE : mHeap.front().mId;
+}
+
+inline size_t LazyHeap::numPairs() const {
+  return mHeap.size();
+}
+
+inline void LazyHeap::push(uint32_t id, double priority) {
+  mPriority[id] = priority;
+  size_t position = mHeap.size();
+  mHeap.push_back(Slot { priority, id });
+  while (position > 0) {
+    size_t parent = (position - 1) / 4;
+    if (!(priority < mHeap[parent].mPriority)) break;
+    mHeap[position] = mHeap[parent];
+    position = parent;
+  }
+  mHeap[position] = Slot { priority, id };
+}
+
+inline void LazyHeap::pop() {
+  Slot slot = mHeap.back();
+  mHeap.pop_back();
+  size_t size = mHeap.size();
+  if (size == 0) return;
+  size_t position = 0;
+  for (;;) {
+    size_t first = position * 4 + 1;
+    if (first >= size) break;
+    size_t last = first + 4 < size ? first + 4 : size;
+    size_t best = first;
+    for (size_t child = first + 1; child < last; ++child) {
+      if (mHeap[child].mPriority < mHeap[best].mPriority) best = child;
+    }
+    if (!(mHeap[best].mPriority < slot.mPriority)) break;
+    mHeap[position] = mHeap[best];
+    position = best;
+  }
+  mHeap[position] = slot;
+}
+
+inline void LazyHeap::dropStale() {
+  while (!mHeap.empty()) {
+    const Slot& top = mHeap.front();
+    if (mContains[top.mId] && top.mPriority == mPriority[top.mId]) return;
+    pop();
+  }
+}
+
+inline void LazyHeap::enqueue(uint32_t id, double priority) {
+  // pairs left from an earlier stay of id are stale unless their priority
+  // matches, and then they stand in for this one until it is extracted
+  push(id, priority);
+  mContains[id] = true;
+  mSize++;
+}
+
+inline uint32_t LazyHeap::extractMin() {
+  // undefined if empty
+  uint32_t min = mHeap.front().mId;
+  pop();
+  mContains[min] = false;
+  mSize--;
+  dropStale();
+  return min;
+}
+
+inline void LazyHeap::decreaseKey(uint32_t id, double newPriority) {
+  // a lighter pair goes on top of the old one if it was the top
+  push(id, newPriority);
+}
+
+#endif
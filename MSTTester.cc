@@ -0,0 +1,662 @@
+#include "CSRGraph.hh"
+#include "UndirectedGraph.hh"
+#include "VertexInterner.hh"
+#include "FlatDisjointSet.hh"
+#include "Prim.hh"
+#include "DensePrim.hh"
+#include "EuclideanMST.hh"
+#include "SingleLinkage.hh"
+#include "SpanningForest.hh"
+#include "Boruvka.hh"
+#include "Kruskal.hh"
+#include "KargerKleinTarjan.hh"
+#include "Chazelle.hh"
+#include "PettieRamachandran.hh"
+#include "SimplifiedSoftHeap.hh"
+#include "DecisionTree.hh"
+#include "MSTVerifier.hh"
+#include "PathMaximum.hh"
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// connected simple random graph: a random spanning path plus extra random
+// edges, with distinct weights so every engine must agree on the same tree
+static std::vector<CSRGraph::Edge> randomGraph(size_t n, size_t m,
+    unsigned seed) {
+  std::mt19937 rng(seed);
+  std::vector<uint32_t> order(n);
+  for (size_t i = 0; i < n; i++) order[i] = i;
+  std::shuffle(order.begin(), order.end(), rng);
+
+  std::vector<CSRGraph::Edge> edges;
+  std::set<std::pair<uint32_t, uint32_t>> present;
+  for (size_t i = 1; i < n; i++) {
+    CSRGraph::Edge edge = { order[i - 1], order[i], 0 };
+    present.insert(std::minmax(edge.first, edge.second));
+    edges.push_back(edge);
+  }
+  while (edges.size() < m) {
+    CSRGraph::Edge edge = { (uint32_t) (rng() % n), (uint32_t) (rng() % n), 0 };
+    if (edge.first == edge.second) continue;
+    if (!present.insert(std::minmax(edge.first, edge.second)).second) continue;
+    edges.push_back(edge);
+  }
+  std::vector<double> weights(edges.size());
+  for (size_t i = 0; i < weights.size(); i++) weights[i] = i + 1;
+  std::shuffle(weights.begin(), weights.end(), rng);
+  for (size_t i = 0; i < edges.size(); i++) edges[i].weight = weights[i];
+  return edges;
+}
+
+// random multigraph of m edges between the first n vertices, self loops
+// included, with integer weights below maxWeight so most of them tie
+static std::vector<CSRGraph::Edge> tiedGraph(size_t n, size_t m,
+    unsigned maxWeight, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::vector<CSRGraph::Edge> edges;
+  for (size_t i = 0; i < m; i++) {
+    CSRGraph::Edge edge = { (uint32_t) (rng() % n), (uint32_t) (rng() % n),
+      (double) (rng() % maxWeight) };
+    edges.push_back(edge);
+  }
+  return edges;
+}
+
+// calls check(n, edges) on five random graphs of growing size, the denser
+// the larger density is
+template <typename Check>
+static void forRandomGraphs(size_t density, Check check) {
+  for (unsigned seed = 0; seed < 5; seed++) {
+    size_t n = 500 + 2000 * seed;
+    check(n, randomGraph(n, (2 + density * seed) * n, seed));
+  }
+}
+
+static double totalWeight(const std::vector<CSRGraph::Edge>& edges) {
+  double total = 0;
+  for (const CSRGraph::Edge& edge : edges) total += edge.weight;
+  return total;
+}
+
+// minimum spanning forest weight by sorting and a union-find
+static double referenceWeight(size_t n, std::vector<CSRGraph::Edge> edges) {
+  std::sort(edges.begin(), edges.end(),
+    [](const CSRGraph::Edge& one, const CSRGraph::Edge& two) {
+      return one.weight < two.weight;
+    });
+  FlatDisjointSet sets(n);
+  double total = 0;
+  for (const CSRGraph::Edge& edge : edges) {
+    if (sets.sameSet(edge.first, edge.second)) continue;
+    sets.unionSets(edge.first, edge.second);
+    total += edge.weight;
+  }
+  return total;
+}
+
+// a forest with the right weight and no cycles is a minimum spanning forest
+static void checkForest(size_t n, const std::vector<CSRGraph::Edge>& edges,
+    const std::vector<CSRGraph::Edge>& forest) {
+  FlatDisjointSet sets(n);
+  for (const CSRGraph::Edge& edge : edges) sets.unionSets(edge.first, edge.second);
+  assert(forest.size() == n - sets.numSets());
+  sets.reset();
+  for (const CSRGraph::Edge& edge : forest) {
+    assert(!sets.sameSet(edge.first, edge.second));
+    sets.unionSets(edge.first, edge.second);
+  }
+  assert(totalWeight(forest) == referenceWeight(n, edges));
+}
+
+static void testCSRGraph() {
+  std::vector<CSRGraph::Edge> edges = {
+    { 0, 1, 1.5 }, { 1, 2, 2.5 }, { 2, 2, 9.0 }, { 0, 3, 0.5 }
+  };
+  CSRGraph graph(5, edges);
+  assert(graph.size() == 5);
+  assert(graph.numEdges() == 3);
+  assert(graph.degree(0) == 2);
+  assert(graph.degree(2) == 1);
+  assert(graph.degree(4) == 0);
+  double sum = 0;
+  for (const auto& edge : graph.edgesFrom(0)) {
+    assert(edge.first == 1 || edge.first == 3);
+    sum += edge.second;
+  }
+  assert(sum == 2.0);
+}
+
+static void testVertexInterner() {
+  VertexInterner<int> interner;
+  assert(interner.isEmpty());
+  for (int i = 0; i < 1000; i++) {
+    assert(interner.intern(i * 7919) == (uint32_t) i);
+  }
+  assert(interner.intern(7919) == 1);
+  assert(interner.size() == 1000);
+  assert(interner.find(7919 * 999) == 999);
+  assert(interner.find(-1) == VertexInterner<int>::NOT_FOUND);
+  assert(interner.valueOf(500) == 500 * 7919);
+}
+
+static void testPrim() {
+  std::vector<CSRGraph::Edge> edges = randomGraph(300, 3000, 1);
+  CSRGraph csr(300, edges);
+  UndirectedGraph<uint32_t> graph;
+  for (const CSRGraph::Edge& edge : edges) {
+    graph.addEdge(edge.first, edge.second, edge.weight);
+  }
+
+  std::vector<CSRGraph::Edge> tree = Prim<uint32_t>::mst(csr);
+  assert(tree.size() == 299);
+
+  UndirectedGraph<uint32_t> mapTree = Prim<uint32_t>::mst(graph);
+  assert(mapTree.size() == 300);
+  double mapWeight = 0;
+  for (const auto& node : mapTree) {
+    for (const auto& edge : node.second) mapWeight += edge.second;
+  }
+  assert(mapWeight / 2 == totalWeight(tree));
+
+  UndirectedGraph<std::string> named;
+  named.addEdge("a", "b", 4);
+  named.addEdge("b", "c", 1);
+  named.addEdge("a", "c", 2);
+  named.addEdge("c", "d", 7);
+  UndirectedGraph<std::string> namedTree = Prim<std::string>::mst(named);
+  assert(namedTree.size() == 4);
+  assert(namedTree.edgesFrom("c").size() == 3);
+  assert(namedTree.edgeCost("a", "c") == 2);
+  assert(!namedTree.edgesFrom("a").count("b"));
+
+  // the same graph generated on demand from adjacency lists
+  std::vector<std::vector<std::pair<uint32_t, double> > > adjacency(300);
+  for (const CSRGraph::Edge& edge : edges) {
+    adjacency[edge.first].push_back(std::make_pair(edge.second, edge.weight));
+    adjacency[edge.second].push_back(std::make_pair(edge.first, edge.weight));
+  }
+  std::vector<CSRGraph::Edge> implicitTree = Prim<uint32_t>::mst(300,
+    [&](uint32_t vertex, auto visit) {
+      for (const auto& neighbor : adjacency[vertex]) {
+        visit(neighbor.first, neighbor.second);
+      }
+    });
+  checkForest(300, edges, implicitTree);
+
+  // every queue policy grows a tree of the same weight
+  double weight = totalWeight(tree);
+  assert(totalWeight(Prim<uint32_t, IndexedDaryHeap<4> >::mst(csr)) == weight);
+  assert(totalWeight(Prim<uint32_t, IndexedPairingHeap>::mst(csr)) == weight);
+  assert(totalWeight(Prim<uint32_t, LazyHeap>::mst(csr)) == weight);
+  std::vector<CSRGraph::Edge> integral = edges;
+  for (CSRGraph::Edge& edge : integral) edge.weight = (int) (edge.weight * 100);
+  CSRGraph integralCsr(300, integral);
+  std::vector<CSRGraph::Edge> integralTree =
+    Prim<uint32_t, IndexedBucketHeap>::mst(integralCsr);
+  checkForest(300, integral, integralTree);
+  assert(totalWeight(integralTree) ==
+         totalWeight(Prim<uint32_t>::mst(integralCsr)));
+}
+
+static void testDensePrim() {
+  const double INF = std::numeric_limits<double>::infinity();
+  // sizes around and past a block of columns, the last vertices isolated
+  // and a third of the other pairs missing, on integer weights with ties
+  for (size_t n : { (size_t) 1, (size_t) 2, (size_t) 37, (size_t) 300,
+                    DensePrim::BLOCK + 3 }) {
+    std::mt19937 rng(n);
+    std::vector<double> matrix(n * n, INF);
+    std::vector<CSRGraph::Edge> edges;
+    size_t connected = n > 10 ? n - 3 : n;
+    for (size_t i = 0; i < connected; i++) {
+      for (size_t j = i + 1; j < connected; j++) {
+        if (rng() % 3 == 0) continue;
+        double weight = rng() % 1000;
+        matrix[i * n + j] = matrix[j * n + i] = weight;
+        CSRGraph::Edge edge = { (uint32_t) i, (uint32_t) j, weight };
+        edges.push_back(edge);
+      }
+    }
+    std::vector<CSRGraph::Edge> tree = DensePrim::mst(n, matrix);
+    checkForest(n, edges, tree);
+    for (const CSRGraph::Edge& edge : tree) {
+      assert(edge.weight == matrix[edge.first * n + edge.second]);
+    }
+    // a non-const pointer is still the matrix, not a row function
+    assert(totalWeight(DensePrim::mst(n, matrix.data())) ==
+           totalWeight(tree));
+
+    std::vector<CSRGraph::Edge> blocked = DensePrim::mst(n,
+      [&](uint32_t vertex, size_t begin, size_t end, double *out) {
+        assert(end - begin <= DensePrim::BLOCK);
+        for (size_t i = begin; i < end; i++) {
+          out[i - begin] = matrix[vertex * n + i];
+        }
+      });
+    checkForest(n, edges, blocked);
+  }
+  assert(DensePrim::mst(0, std::vector<double>()).empty());
+
+  // complete graphs from a distance function, against the same graph as a
+  // matrix and through Prim with the neighbors generated; coordinates are
+  // integers so every order of summing the weights gives the same total
+  std::mt19937 rng(16);
+  size_t n = 500;
+  std::vector<std::pair<double, double> > points(n);
+  for (auto& point : points) {
+    point = std::make_pair(rng() % 1000, rng() % 1000);
+  }
+  auto distance = [&](uint32_t one, uint32_t two) {
+    double dx = points[one].first - points[two].first;
+    double dy = points[one].second - points[two].second;
+    return dx * dx + dy * dy;
+  };
+  std::vector<double> matrix(n * n);
+  std::vector<CSRGraph::Edge> edges;
+  for (uint32_t i = 0; i < n; i++) {
+    for (uint32_t j = 0; j < n; j++) {
+      matrix[i * n + j] = distance(i, j);
+      if (i < j) edges.push_back(CSRGraph::Edge { i, j, distance(i, j) });
+    }
+  }
+  std::vector<CSRGraph::Edge> complete = DensePrim::complete(n, distance);
+  checkForest(n, edges, complete);
+  assert(totalWeight(complete) == totalWeight(DensePrim::mst(n, matrix)));
+  std::vector<CSRGraph::Edge> generated = Prim<uint32_t>::mst(n,
+    [&](uint32_t vertex, auto visit) {
+      for (uint32_t i = 0; i < n; i++) {
+        if (i != vertex) visit(i, distance(vertex, i));
+      }
+    });
+  checkForest(n, edges, generated);
+}
+
+// the sorted weights of every minimum spanning tree of a graph are the same,
+// whichever of several equal edges each one took
+static std::vector<double> sortedWeights(std::vector<CSRGraph::Edge> tree) {
+  std::vector<double> weights;
+  for (const CSRGraph::Edge& edge : tree) weights.push_back(edge.weight);
+  std::sort(weights.begin(), weights.end());
+  return weights;
+}
+
+template <size_t D>
+static void checkEuclidean(const std::vector<double>& points) {
+  size_t n = points.size() / D;
+  auto distance = [&](uint32_t one, uint32_t two) {
+    double sum = 0;
+    for (size_t k = 0; k < D; k++) {
+      double delta = points[one * D + k] - points[two * D + k];
+      sum += delta * delta;
+    }
+    return std::sqrt(sum);
+  };
+  std::vector<CSRGraph::Edge> tree = EuclideanMST<D>::mst(points);
+  assert(tree.size() == (n ? n - 1 : 0));
+  FlatDisjointSet sets(n);
+  for (const CSRGraph::Edge& edge : tree) {
+    assert(!sets.sameSet(edge.first, edge.second));
+    sets.unionSets(edge.first, edge.second);
+    assert(edge.weight == distance(edge.first, edge.second));
+  }
+  assert(sortedWeights(tree) ==
+         sortedWeights(DensePrim::complete(n, distance)));
+}
+
+static void testEuclideanMST() {
+  std::mt19937 rng(18);
+  std::uniform_real_distribution<double> coordinate(0.0, 1.0);
+  for (size_t n : { 0, 1, 2, 17, 1000, 3000 }) {
+    std::vector<double> plane(2 * n);
+    for (double& value : plane) value = coordinate(rng);
+    checkEuclidean<2>(plane);
+    std::vector<double> space(3 * n);
+    for (double& value : space) value = coordinate(rng);
+    checkEuclidean<3>(space);
+  }
+
+  // a grid is all ties, and copies of a point can't be split by the tree
+  std::vector<double> grid;
+  for (int x = 0; x < 40; x++) {
+    for (int y = 0; y < 40; y++) {
+      grid.push_back(x);
+      grid.push_back(y);
+    }
+  }
+  for (int copy = 0; copy < 50; copy++) {
+    grid.push_back(7);
+    grid.push_back(7);
+  }
+  checkEuclidean<2>(grid);
+  std::vector<double> clustered(5 * 2000);
+  for (size_t i = 0; i < clustered.size(); i++) {
+    clustered[i] = (i / 5 % 10) * 100 + coordinate(rng);
+  }
+  checkEuclidean<5>(clustered);
+}
+
+static void testSingleLinkage() {
+  // 0 - 1 at 1, 2 - 3 at 2, then the pairs join at 5, 4 hangs on at 9
+  std::vector<CSRGraph::Edge> forest = {
+    { 3, 4, 9 }, { 1, 2, 5 }, { 0, 1, 1 }, { 2, 3, 2 }
+  };
+  std::vector<SingleLinkage::Merge> merges = SingleLinkage::linkage(5, forest);
+  assert(merges.size() == 4);
+  assert(merges[0].left == 0 && merges[0].right == 1);
+  assert(merges[0].height == 1 && merges[0].size == 2);
+  assert(merges[1].left == 2 && merges[1].right == 3 && merges[1].size == 2);
+  assert(merges[2].left == 5 && merges[2].right == 6);
+  assert(merges[2].height == 5 && merges[2].size == 4);
+  assert(merges[3].left == 4 && merges[3].right == 7);
+  assert(merges[3].height == 9 && merges[3].size == 5);
+  assert(SingleLinkage::linkage(5, forest, 3).size() == 2);
+  std::vector<uint32_t> labels = SingleLinkage::clusters(5, forest, 3);
+  assert((labels == std::vector<uint32_t> { 0, 0, 1, 1, 2 }));
+  assert(SingleLinkage::clusters(5, forest, 9).back() == 4);
+
+  // on a random graph's tree, the cut at k clusters is the components of
+  // the edges lighter than the (n - k)th lightest tree edge
+  size_t n = 2000;
+  std::vector<CSRGraph::Edge> edges = randomGraph(n, 8 * n, 19);
+  std::vector<CSRGraph::Edge> tree = Prim<uint32_t>::mst(CSRGraph(n, edges));
+  std::vector<SingleLinkage::Merge> full = SingleLinkage::linkage(n, tree);
+  assert(full.size() == n - 1);
+  assert(full.back().size == n);
+  for (size_t i = 0; i < full.size(); i++) {
+    assert(full[i].left < full[i].right && full[i].right < n + i);
+    if (i > 0) assert(full[i - 1].height <= full[i].height);
+  }
+  for (size_t k : { (size_t) 1, (size_t) 7, (size_t) 500, n }) {
+    std::vector<SingleLinkage::Merge> cut = SingleLinkage::linkage(n, tree, k);
+    assert(cut.size() == n - k);
+    for (size_t i = 0; i < cut.size(); i++) {
+      assert(cut[i].left == full[i].left && cut[i].right == full[i].right);
+    }
+    labels = SingleLinkage::clusters(n, tree, k);
+    FlatDisjointSet sets(n);
+    for (const CSRGraph::Edge& edge : tree) {
+      if (n - k > 0 && edge.weight <= full[n - k - 1].height) {
+        sets.unionSets(edge.first, edge.second);
+      }
+    }
+    assert(sets.numSets() == k);
+    assert(*std::max_element(labels.begin(), labels.end()) == k - 1);
+    for (const CSRGraph::Edge& edge : tree) {
+      assert((labels[edge.first] == labels[edge.second]) ==
+             sets.sameSet(edge.first, edge.second));
+    }
+  }
+}
+
+static void testSpanningForest() {
+  // random components of many sizes, some of them bare trees, scattered
+  // over the ids, with isolated vertices and self loops in between
+  size_t n = 0;
+  std::vector<CSRGraph::Edge> edges;
+  std::mt19937 rng(20);
+  for (unsigned seed = 0; seed < 60; seed++) {
+    size_t size = 1 + rng() % (seed % 10 == 0 ? 3000 : 40);
+    size_t m = seed % 3 == 0 ? size - 1 : std::min(4 * size,
+                                                   size * (size - 1) / 2);
+    for (CSRGraph::Edge edge : randomGraph(size, m, seed)) {
+      edge.first += n;
+      edge.second += n;
+      edges.push_back(edge);
+    }
+    n += size + seed % 4;
+  }
+  for (size_t i = 0; i < 20; i++) {
+    uint32_t vertex = rng() % n;
+    CSRGraph::Edge loop = { vertex, vertex, 0.5 };
+    edges.push_back(loop);
+  }
+  std::shuffle(edges.begin(), edges.end(), rng);
+
+  for (size_t threads : { 1, 4 }) {
+    checkForest(n, edges,
+                SpanningForest<uint32_t>::mst(n, edges, threads));
+    checkForest(n, edges,
+                SpanningForest<uint32_t, LazyHeap>::mst(CSRGraph(n, edges),
+                                                        threads));
+  }
+  assert(SpanningForest<uint32_t>::mst(0,
+                                       std::vector<CSRGraph::Edge>()).empty());
+  assert(SpanningForest<uint32_t>::mst(5,
+                                       std::vector<CSRGraph::Edge>()).empty());
+
+  UndirectedGraph<std::string> named;
+  named.addEdge("a", "b", 4);
+  named.addEdge("b", "c", 1);
+  named.addEdge("a", "c", 2);
+  named.addEdge("x", "y", 3);
+  named.addNode("z");
+  UndirectedGraph<std::string> namedForest =
+    SpanningForest<std::string>::mst(named, 2);
+  assert(namedForest.size() == 6);
+  assert(namedForest.edgeCost("a", "c") == 2);
+  assert(namedForest.edgeCost("x", "y") == 3);
+  assert(!namedForest.edgesFrom("a").count("b"));
+  assert(namedForest.edgesFrom("z").empty());
+}
+
+static void testBoruvka() {
+  for (unsigned seed = 0; seed < 5; seed++) {
+    size_t n = 100 + 400 * seed;
+    std::vector<CSRGraph::Edge> edges = randomGraph(n, 6 * n, seed);
+    CSRGraph csr(n, edges);
+    std::vector<CSRGraph::Edge> tree = Boruvka<uint32_t>::mst(csr, 4);
+    checkForest(n, edges, tree);
+    assert(totalWeight(tree) == totalWeight(Prim<uint32_t>::mst(csr)));
+  }
+
+  // disconnected, with isolated vertices, a self loop and tied weights
+  std::vector<CSRGraph::Edge> edges = {
+    { 0, 1, 1 }, { 1, 2, 1 }, { 0, 2, 1 }, { 4, 5, 2 }, { 5, 5, 0 },
+    { 6, 7, 3 }, { 7, 8, 3 }, { 6, 8, 1 }
+  };
+  std::vector<CSRGraph::Edge> forest = Boruvka<uint32_t>::mst(10, edges, 3);
+  checkForest(10, edges, forest);
+  assert(Boruvka<uint32_t>::mst(0, std::vector<CSRGraph::Edge>()).empty());
+}
+
+static void testKruskal() {
+  for (unsigned seed = 0; seed < 5; seed++) {
+    size_t n = 1000 + 3000 * seed;
+    std::vector<CSRGraph::Edge> edges = randomGraph(n, 8 * n, seed);
+    checkForest(n, edges, Kruskal<uint32_t>::mst(n, edges, 4));
+    checkForest(n, edges, Kruskal<uint32_t>::filterMst(n, edges, 4));
+  }
+
+  // many tied weights and a disconnected remainder
+  std::vector<CSRGraph::Edge> edges = tiedGraph(5000, 30000, 3, 3);
+  checkForest(6000, edges, Kruskal<uint32_t>::filterMst(6000, edges, 2));
+  checkForest(6000, edges, Kruskal<uint32_t>::mst(6000, edges, 2));
+
+  // a pivot at the largest weight splits off its ties, and a range of one
+  // weight only is sorted whole
+  for (CSRGraph::Edge& edge : edges) edge.weight = edge.weight == 2 ? 2 : 1;
+  checkForest(6000, edges, Kruskal<uint32_t>::filterMst(6000, edges, 2));
+  for (CSRGraph::Edge& edge : edges) edge.weight = 1;
+  checkForest(6000, edges, Kruskal<uint32_t>::filterMst(6000, edges, 2));
+}
+
+static void testKargerKleinTarjan() {
+  forRandomGraphs(3, [](size_t n, const std::vector<CSRGraph::Edge>& edges) {
+    checkForest(n, edges, KargerKleinTarjan<uint32_t>::mst(n, edges));
+  });
+
+  // the last thousand vertices are isolated
+  std::vector<CSRGraph::Edge> edges = tiedGraph(8000, 40000, 4, 9);
+  checkForest(9000, edges, KargerKleinTarjan<uint32_t>::mst(9000, edges));
+}
+
+static void testChazelle() {
+  // a large error rate makes the soft heaps corrupt plenty of edges
+  double epsilons[] = { 0.5, 0.125, 0.01 };
+  forRandomGraphs(6, [&](size_t n, const std::vector<CSRGraph::Edge>& edges) {
+    for (double epsilon : epsilons) {
+      checkForest(n, edges, Chazelle<uint32_t>::mst(n, edges, epsilon));
+      checkForest(n, edges, Chazelle<uint32_t, SimplifiedSoftHeap<size_t> >
+                  ::mst(n, edges, epsilon));
+    }
+  });
+
+  std::vector<CSRGraph::Edge> edges = tiedGraph(8000, 40000, 4, 9);
+  for (double epsilon : epsilons) {
+    checkForest(9000, edges, Chazelle<uint32_t>::mst(9000, edges, epsilon));
+    checkForest(9000, edges, Chazelle<uint32_t, SimplifiedSoftHeap<size_t> >
+                ::mst(9000, edges, epsilon));
+  }
+}
+
+static void testDecisionTree() {
+  // every subgraph of K4 under random weights with plenty of ties
+  std::mt19937 rng(11);
+  for (size_t trial = 0; trial < 20000; trial++) {
+    uint8_t present = rng() % 64;
+    double weights[DecisionTree::NUM_SLOTS];
+    size_t origins[DecisionTree::NUM_SLOTS];
+    std::vector<CSRGraph::Edge> edges;
+    for (uint32_t first = 0; first < 4; first++) {
+      for (uint32_t second = first + 1; second < 4; second++) {
+        size_t slot = DecisionTree::slot(first, second);
+        weights[slot] = rng() % 4;
+        origins[slot] = edges.size();
+        if (present >> slot & 1) {
+          CSRGraph::Edge edge = { first, second, weights[slot] };
+          edges.push_back(edge);
+        }
+      }
+    }
+    uint8_t tree = DecisionTree::msf(weights, origins, present);
+    assert((tree & ~present) == 0);
+    std::vector<CSRGraph::Edge> forest;
+    for (const CSRGraph::Edge& edge : edges) {
+      if (tree >> DecisionTree::slot(edge.first, edge.second) & 1) {
+        forest.push_back(edge);
+      }
+    }
+    checkForest(4, edges, forest);
+  }
+}
+
+static void testPettieRamachandran() {
+  double epsilons[] = { 0.5, 0.125, 0.01 };
+  forRandomGraphs(6, [&](size_t n, const std::vector<CSRGraph::Edge>& edges) {
+    for (double epsilon : epsilons) {
+      checkForest(n, edges,
+                  PettieRamachandran<uint32_t>::mst(n, edges, epsilon));
+      checkForest(n, edges,
+                  PettieRamachandran<uint32_t, SimplifiedSoftHeap<size_t> >
+                  ::mst(n, edges, epsilon));
+    }
+  });
+
+  std::vector<CSRGraph::Edge> edges = tiedGraph(8000, 40000, 4, 9);
+  for (double epsilon : epsilons) {
+    checkForest(9000, edges,
+                PettieRamachandran<uint32_t>::mst(9000, edges, epsilon));
+    checkForest(9000, edges,
+                PettieRamachandran<uint32_t, SimplifiedSoftHeap<size_t> >
+                ::mst(9000, edges, epsilon));
+  }
+}
+
+static void testMSTVerifier() {
+  // path maxima against the binary lifting ones, on forests with ties
+  std::mt19937 rng(13);
+  for (size_t trial = 0; trial < 20; trial++) {
+    size_t n = 1 + rng() % 3000;
+    std::vector<FlatDisjointSetForest::Edge> forest;
+    for (uint32_t v = 1; v < n; v++) {
+      if (rng() % 10 == 0) continue;
+      FlatDisjointSetForest::Edge edge =
+        { (uint32_t) (rng() % v), v, (double) (rng() % 8), forest.size() };
+      forest.push_back(edge);
+    }
+    std::vector<FlatDisjointSetForest::Edge> queries;
+    for (size_t i = 0; i < 4 * n; i++) {
+      FlatDisjointSetForest::Edge query = { (uint32_t) (rng() % n),
+        (uint32_t) (rng() % n), (double) (rng() % 8), n + i };
+      queries.push_back(query);
+    }
+    MSTVerifier verifier(n, forest);
+    PathMaximum paths(n, forest);
+    std::vector<size_t> maxes;
+    std::vector<uint8_t> heavy;
+    verifier.maxEdges(queries, maxes);
+    verifier.heavyEdges(queries, heavy);
+    for (size_t i = 0; i < queries.size(); i++) {
+      uint32_t first = queries[i].first;
+      uint32_t second = queries[i].second;
+      if (first == second || !paths.connected(first, second)) {
+        assert(maxes[i] == MSTVerifier::NONE);
+      } else {
+        assert(maxes[i] == paths.maxEdge(first, second));
+      }
+      assert((bool) heavy[i] == paths.isHeavy(queries[i]));
+    }
+  }
+
+  for (unsigned seed = 0; seed < 5; seed++) {
+    size_t n = 500 + 2000 * seed;
+    std::vector<CSRGraph::Edge> edges = randomGraph(n, (2 + 3 * seed) * n, seed);
+    std::vector<CSRGraph::Edge> tree = Kruskal<uint32_t>::mst(n, edges);
+    std::vector<size_t> light;
+    assert(MSTVerifier::isMinimum(n, edges, tree, &light));
+    // the weights are distinct, so no non-tree edge ties its path
+    assert(light.empty());
+
+    // swap a tree edge for the non-tree edge that reconnects the tree most
+    // cheaply without it, which has to be heavier
+    std::vector<CSRGraph::Edge> broken(tree.begin() + 1, tree.end());
+    FlatDisjointSet sets(n);
+    for (const CSRGraph::Edge& edge : broken) sets.unionSets(edge.first, edge.second);
+    size_t reconnect = edges.size();
+    for (size_t i = 0; i < edges.size(); i++) {
+      if (sets.sameSet(edges[i].first, edges[i].second)) continue;
+      if (edges[i].weight == tree[0].weight) continue;
+      if (reconnect == edges.size() || edges[i].weight < edges[reconnect].weight) {
+        reconnect = i;
+      }
+    }
+    assert(!MSTVerifier::isMinimum(n, edges, broken));
+    if (reconnect == edges.size()) continue;
+    broken.push_back(edges[reconnect]);
+    light.clear();
+    assert(!MSTVerifier::isMinimum(n, edges, broken, &light));
+    assert(!light.empty());
+    // a tree edge that isn't in the graph at all
+    std::vector<CSRGraph::Edge> fake(tree);
+    fake[0].weight -= 1;
+    assert(!MSTVerifier::isMinimum(n, edges, fake));
+  }
+}
+
+int main() {
+  testCSRGraph();
+  testVertexInterner();
+  testPrim();
+  testDensePrim();
+  testEuclideanMST();
+  testSingleLinkage();
+  testSpanningForest();
+  testBoruvka();
+  testKruskal();
+  testKargerKleinTarjan();
+  testChazelle();
+  testDecisionTree();
+  testPettieRamachandran();
+  testMSTVerifier();
+  std::cout << "all MST tests passed" << std::endl;
+  return 0;
+}
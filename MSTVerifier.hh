@@ -0,0 +1,399 @@
+/*
+ * MST Verifier
+ *
+ * Decides whether a spanning forest is minimum, and more generally finds
+ * the heaviest forest edge on the path between the endpoints of a whole
+ * batch of query edges at once. KargerKleinTarjan and PettieRamachandran
+ * use it as their F-heavy filter. It follows King's simplification of
+ * Komlos offline, but it is not the linear time verifier their bounds
+ * assume, see below.
+ *
+ * The constructor builds the Boruvka tree B of the forest: its leaves are
+ * the forest's vertices and each Boruvka step over the forest adds a node
+ * for every merged component, parented above the components it swallowed
+ * through the edge each of them picked. King shows the heaviest edge on a
+ * forest path is the heaviest on the B path between the same leaves, and
+ * B is full branching, so it is at most about log n deep.
+ *
+ * Queries are answered offline in one depth first walk over B, at the
+ * later of their two leaves, the way Tarjan evaluates path maxima with
+ * path compression: a union-find whose links point up B and carry the
+ * heaviest edge on the way gives the half of the path from the earlier
+ * leaf, and its root is the lowest common ancestor. The half from the
+ * current leaf comes from a table of maxima along the current root path,
+ * which B's depth keeps tiny. Komlos' comparison-optimal bookkeeping and
+ * King's word packing, which together make verification linear, are left
+ * out, so the total is O(m alpha(m, n)) time plus O(log n) per node of B,
+ * O(m alpha(m, n) + n log n) in all. Forest edges are replaced by their
+ * rank in the (weight, origin) order, so every comparison is an integer
+ * max and results are exact even with ties.
+ */
+
+#ifndef MSTVerifier_Included
+#define MSTVerifier_Included
+
+#include "CSRGraph.hh"
+#include "FlatDisjointSet.hh"
+#include "FlatDisjointSetForest.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class MSTVerifier {
+  public:
+    typedef FlatDisjointSetForest::Edge Edge;
+
+    static constexpr size_t NONE = SIZE_MAX;
+
+    // keeps a reference to forest, which has to outlive the queries and
+    // must not contain a cycle
+    MSTVerifier(size_t numVertices, const std::vector<Edge>& forest);
+    ~MSTVerifier();
+
+    // result[i] is the position in the forest of the heaviest edge on the
+    // path between the endpoints of queries[i], NONE if there is no path
+    // or the endpoints are equal. Any edge type with first and second works.
+    template <typename QueryEdge>
+    void maxEdges(const std::vector<QueryEdge>& queries,
+                  std::vector<size_t>& result) const;
+    // heavy[i] is set if queries[i] is F-heavy, so it can't be in the MST
+    void heavyEdges(const std::vector<Edge>& queries,
+                    std::vector<uint8_t>& heavy) const;
+
+    // true if tree is a minimum spanning forest of the graph. If light is
+    // given it receives the positions of the non-tree edges that are
+    // F-light with respect to tree, which for a minimum tree are only ones
+    // tied with the heaviest edge on their tree path. For a CSRGraph the
+    // positions are into graph.edgeList().
+    static bool isMinimum(size_t numVertices,
+                          const std::vector<CSRGraph::Edge>& edges,
+                          const std::vector<CSRGraph::Edge>& tree,
+                          std::vector<size_t> *light = NULL);
+    static bool isMinimum(const CSRGraph& graph,
+                          const std::vector<CSRGraph::Edge>& tree,
+                          std::vector<size_t> *light = NULL);
+
+  private:
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+    // a query as seen from one of its leaves
+    struct Slot {
+      uint32_t leaf;
+      uint32_t other;
+      size_t query;
+    };
+
+    // a link up B: where it goes and the heaviest edge on the way, as one
+    // plus its rank in the (weight, origin) order, so 0 is no edge at all
+    // and the heavier of two edges is the larger number
+    struct Link {
+      uint32_t to;
+      uint32_t heaviest;
+    };
+
+    const std::vector<Edge>& mForest;
+    size_t mNumVertices;
+    // the forest positions of the edges by rank
+    std::vector<size_t> mByRank;
+    // the nodes of B, leaves first; a parent always comes after its
+    // children, and the link names the edge the node's component picked
+    std::vector<Link> mParent;
+    std::vector<uint8_t> mDepth;
+    std::vector<size_t> mChildOffsets;
+    std::vector<uint32_t> mChildren;
+
+    static inline bool lighter(const Edge& one, const Edge& two);
+};
+
+inline MSTVerifier::MSTVerifier(size_t numVertices,
+    const std::vector<Edge>& forest) :
+  mForest(forest), mNumVertices(numVertices), mByRank(forest.size()) {
+  for (size_t i = 0; i < forest.size(); ++i) mByRank[i] = i;
+  std::sort(mByRank.begin(), mByRank.end(), [&forest](size_t one, size_t two) {
+    return lighter(forest[one], forest[two]);
+  });
+  std::vector<uint32_t> rank(forest.size());
+  for (size_t r = 0; r < forest.size(); ++r) rank[mByRank[r]] = r + 1;
+
+  Link none = { NO_NODE, 0 };
+  mParent.assign(numVertices, none);
+  // node[root] is the B node of the component with that root
+  std::vector<uint32_t> node(numVertices);
+  for (size_t v = 0; v < numVertices; ++v) node[v] = v;
+  std::vector<size_t> live(forest.size());
+  for (size_t i = 0; i < forest.size(); ++i) live[i] = i;
+
+  FlatDisjointSet sets(numVertices);
+  std::vector<uint32_t> cheapest(numVertices, 0);
+  std::vector<uint32_t> stamp(numVertices, 0);
+  std::vector<uint32_t> touched;
+  std::vector<uint32_t> picked;
+  for (uint32_t step = 1; !live.empty(); ++step) {
+    // every component with a forest edge left picks its lightest one
+    touched.clear();
+    for (size_t i : live) {
+      uint32_t ends[2] = { sets.find(forest[i].first),
+                           sets.find(forest[i].second) };
+      for (uint32_t end : ends) {
+        if (cheapest[end] == 0) touched.push_back(end);
+        if (cheapest[end] == 0 || rank[i] < cheapest[end]) {
+          cheapest[end] = rank[i];
+        }
+      }
+    }
+    picked.clear();
+    for (uint32_t end : touched) picked.push_back(node[end]);
+    for (uint32_t end : touched) {
+      const Edge& edge = forest[mByRank[cheapest[end] - 1]];
+      sets.unionSets(edge.first, edge.second);
+    }
+
+    // one new B node per merged component, above the ones it swallowed
+    for (size_t t = 0; t < touched.size(); ++t) {
+      uint32_t root = sets.find(touched[t]);
+      if (stamp[root] != step) {
+        stamp[root] = step;
+        node[root] = mParent.size();
+        mParent.push_back(none);
+      }
+      mParent[picked[t]].to = node[root];
+      mParent[picked[t]].heaviest = cheapest[touched[t]];
+    }
+    for (uint32_t end : touched) cheapest[end] = 0;
+
+    size_t kept = 0;
+    for (size_t i : live) {
+      if (!sets.sameSet(forest[i].first, forest[i].second)) live[kept++] = i;
+    }
+    live.resize(kept);
+  }
+
+  size_t numNodes = mParent.size();
+  mDepth.assign(numNodes, 0);
+  for (size_t x = numNodes; x-- > 0; ) {
+    if (mParent[x].to != NO_NODE) mDepth[x] = mDepth[mParent[x].to] + 1;
+  }
+  mChildOffsets.assign(numNodes + 1, 0);
+  for (size_t x = 0; x < numNodes; ++x) {
+    if (mParent[x].to != NO_NODE) mChildOffsets[mParent[x].to + 1]++;
+  }
+  for (size_t x = 0; x < numNodes; ++x) {
+    mChildOffsets[x + 1] += mChildOffsets[x];
+  }
+  mChildren.resize(mChildOffsets[numNodes]);
+  std::vector<size_t> cursor(mChildOffsets.begin(), mChildOffsets.end() - 1);
+  for (size_t x = 0; x < numNodes; ++x) {
+    if (mParent[x].to != NO_NODE) mChildren[cursor[mParent[x].to]++] = x;
+  }
+}
+
+inline MSTVerifier::~MSTVerifier() {
+  // Does nothing.
+}
+
+inline bool MSTVerifier::lighter(const Edge& one, const Edge& two) {
+  return one.weight < two.weight ||
+    (one.weight == two.weight && one.origin < two.origin);
+}
+
+template <typename QueryEdge>
+void MSTVerifier::maxEdges(const std::vector<QueryEdge>& queries,
+                           std::vector<size_t>& result) const {
+  size_t numNodes = mParent.size();
+  result.assign(queries.size(), NONE);
+  if (mNumVertices == 0) return;
+
+  // the queries at every leaf in CSR form, each one shows up at both ends.
+  // Scattering straight to the leaves misses the cache on every write, so
+  // they go into at most 2^11 coarse buckets by the high bits of the leaf
+  // first and are only then spread out within their cache sized bucket
+  size_t shift = 0;
+  while ((mNumVertices - 1) >> shift >= ((size_t) 1 << 11)) shift++;
+  size_t numBuckets = ((mNumVertices - 1) >> shift) + 1;
+  std::vector<size_t> bucketOffsets(numBuckets + 1, 0);
+  for (const QueryEdge& query : queries) {
+    if (query.first == query.second) continue;
+    bucketOffsets[(query.first >> shift) + 1]++;
+    bucketOffsets[(query.second >> shift) + 1]++;
+  }
+  for (size_t b = 0; b < numBuckets; ++b) {
+    bucketOffsets[b + 1] += bucketOffsets[b];
+  }
+  std::vector<size_t> cursor(bucketOffsets.begin(), bucketOffsets.end() - 1);
+  // left uninitialized, every slot is written before it is read
+  std::unique_ptr<Slot[]> atLeaf(new Slot[bucketOffsets[numBuckets]]);
+  for (size_t i = 0; i < queries.size(); ++i) {
+    uint32_t first = queries[i].first;
+    uint32_t second = queries[i].second;
+    if (first == second) continue;
+    Slot one = { first, second, i };
+    Slot two = { second, first, i };
+    atLeaf[cursor[first >> shift]++] = one;
+    atLeaf[cursor[second >> shift]++] = two;
+  }
+
+  std::vector<size_t> offsets(mNumVertices + 1, 0);
+  cursor.resize(mNumVertices);
+  std::vector<Slot> bucket;
+  for (size_t b = 0; b < numBuckets; ++b) {
+    size_t begin = bucketOffsets[b];
+    size_t end = bucketOffsets[b + 1];
+    size_t low = b << shift;
+    size_t high = std::min((b + 1) << shift, mNumVertices);
+    for (size_t slot = begin; slot < end; ++slot) {
+      offsets[atLeaf[slot].leaf + 1]++;
+    }
+    offsets[low] = begin;
+    for (size_t v = low; v < high; ++v) {
+      offsets[v + 1] += offsets[v];
+      cursor[v] = offsets[v];
+    }
+    bucket.assign(atLeaf.get() + begin, atLeaf.get() + end);
+    for (const Slot& slot : bucket) atLeaf[cursor[slot.leaf]++] = slot;
+  }
+  cursor.clear();
+  cursor.shrink_to_fit();
+  bucket.clear();
+  bucket.shrink_to_fit();
+
+  uint8_t maxDepth = 0;
+  for (size_t x = 0; x < numNodes; ++x) {
+    if (mDepth[x] > maxDepth) maxDepth = mDepth[x];
+  }
+  // heaviest[k][d] is the heaviest edge from the node at depth k on the
+  // current root path up to the one at depth d
+  std::vector<std::vector<uint32_t> > heaviest(maxDepth + 1,
+      std::vector<uint32_t>(maxDepth + 1, 0));
+  std::vector<uint32_t> path(maxDepth + 1);
+  // a union-find whose links only point up B, to the link's heaviest edge;
+  // the root of a finished node is its lowest unfinished ancestor
+  Link none = { NO_NODE, 0 };
+  std::vector<Link> links(numNodes, none);
+  for (size_t x = 0; x < numNodes; ++x) links[x].to = x;
+  std::vector<uint32_t> chain;
+
+  std::vector<std::pair<uint32_t, size_t> > stack;
+  for (size_t root = 0; root < numNodes; ++root) {
+    if (mParent[root].to != NO_NODE) continue;
+    stack.push_back(std::make_pair((uint32_t) root, mChildOffsets[root]));
+    path[0] = root;
+    while (!stack.empty()) {
+      uint32_t x = stack.back().first;
+      size_t next = stack.back().second;
+      if (next < mChildOffsets[x + 1]) {
+        stack.back().second++;
+        uint32_t child = mChildren[next];
+        size_t k = mDepth[child];
+        path[k] = child;
+        uint32_t edge = mParent[child].heaviest;
+        for (size_t d = 0; d + 1 < k; ++d) {
+          heaviest[k][d] = std::max(heaviest[k - 1][d], edge);
+        }
+        heaviest[k][k - 1] = edge;
+        stack.push_back(std::make_pair(child, mChildOffsets[child]));
+        continue;
+      }
+
+      // answer the queries whose other leaf was finished before this one
+      if (x < mNumVertices) {
+        size_t k = mDepth[x];
+        size_t end = offsets[x + 1];
+        for (size_t slot = offsets[x]; slot < end; ++slot) {
+          // the other leaves are all over memory, so ask for them early
+#if defined(__GNUC__)
+          if (slot + 8 < end) {
+            __builtin_prefetch(&links[atLeaf[slot + 8].other]);
+          }
+#endif
+          uint32_t other = atLeaf[slot].other;
+          if (links[other].to == other) continue;
+          // compress the path from other up to its root, keeping maxima
+          chain.clear();
+          uint32_t top = other;
+          while (links[top].to != top) {
+            chain.push_back(top);
+            top = links[top].to;
+          }
+          if (path[mDepth[top]] != top) continue;
+          for (size_t c = chain.size() - 1; c-- > 0; ) {
+            Link& link = links[chain[c]];
+            link.heaviest = std::max(link.heaviest, links[link.to].heaviest);
+            link.to = top;
+          }
+          uint32_t edge = std::max(links[other].heaviest,
+                                   heaviest[k][mDepth[top]]);
+          result[atLeaf[slot].query] = mByRank[edge - 1];
+        }
+      }
+      stack.pop_back();
+      links[x] = mParent[x];
+      if (links[x].to == NO_NODE) links[x].to = x;
+    }
+  }
+}
+
+inline void MSTVerifier::heavyEdges(const std::vector<Edge>& queries,
+                                    std::vector<uint8_t>& heavy) const {
+  std::vector<size_t> maxes;
+  maxEdges(queries, maxes);
+  heavy.assign(queries.size(), 0);
+  for (size_t i = 0; i < queries.size(); ++i) {
+    heavy[i] = maxes[i] != NONE && lighter(mForest[maxes[i]], queries[i]);
+  }
+}
+
+inline bool MSTVerifier::isMinimum(const CSRGraph& graph,
+                                   const std::vector<CSRGraph::Edge>& tree,
+                                   std::vector<size_t> *light) {
+  return isMinimum(graph.size(), graph.edgeList(), tree, light);
+}
+
+inline bool MSTVerifier::isMinimum(size_t numVertices,
+                                   const std::vector<CSRGraph::Edge>& edges,
+                                   const std::vector<CSRGraph::Edge>& tree,
+                                   std::vector<size_t> *light) {
+  std::vector<Edge> forest;
+  forest.reserve(tree.size());
+  FlatDisjointSet sets(numVertices);
+  for (size_t i = 0; i < tree.size(); ++i) {
+    if (sets.sameSet(tree[i].first, tree[i].second)) return false;
+    sets.unionSets(tree[i].first, tree[i].second);
+    Edge edge = { tree[i].first, tree[i].second, tree[i].weight, i };
+    forest.push_back(edge);
+  }
+
+  std::vector<size_t> maxes;
+  MSTVerifier(numVertices, forest).maxEdges(edges, maxes);
+
+  bool minimum = true;
+  std::vector<bool> inGraph(tree.size(), false);
+  for (size_t i = 0; i < edges.size(); ++i) {
+    const CSRGraph::Edge& edge = edges[i];
+    if (edge.first == edge.second) continue;
+    // the tree doesn't connect the endpoints, so it doesn't span
+    if (maxes[i] == NONE) {
+      minimum = false;
+      if (light) light->push_back(i);
+      continue;
+    }
+    // the path between the ends of a tree edge is the edge itself
+    const Edge& heaviest = forest[maxes[i]];
+    if (heaviest.weight == edge.weight &&
+        ((heaviest.first == edge.first && heaviest.second == edge.second) ||
+         (heaviest.first == edge.second && heaviest.second == edge.first))) {
+      inGraph[maxes[i]] = true;
+      continue;
+    }
+    if (edge.weight < heaviest.weight) minimum = false;
+    if (light && edge.weight <= heaviest.weight) light->push_back(i);
+  }
+  for (size_t i = 0; i < tree.size(); ++i) {
+    if (!inGraph[i]) return false;
+  }
+  return minimum;
+}
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * Times MSTVerifier::isMinimum on a tree from Prim::mst against computing
+ * that tree, on random connected graphs with a fixed vertex count and a
+ * growing edge density m/n. Both sides start from the edge list.
+ *
+ * usage: MSTVerifierBench [vertices] [maxDensity]
+ */
+
+#include "CSRGraph.hh"
+#include "Prim.hh"
+#include "MSTVerifier.hh"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 1000000;
+  size_t maxDensity = argc > 2 ? std::strtoull(argv[2], NULL, 10) : 16;
+
+  std::cout << "vertices " << n << std::endl;
+  std::cout << "m/n   prim(s)     verify(s)   speedup" << std::endl;
+  for (size_t density = 2; density <= maxDensity; density *= 2) {
+    std::mt19937_64 rng(density);
+    std::uniform_real_distribution<double> weight(0.0, 1.0);
+    std::vector<CSRGraph::Edge> edges;
+    edges.reserve(density * n);
+    for (size_t i = 1; i < n; i++) {
+      CSRGraph::Edge edge = { (uint32_t) (rng() % i), (uint32_t) i, weight(rng) };
+      edges.push_back(edge);
+    }
+    while (edges.size() < density * n) {
+      CSRGraph::Edge edge = { (uint32_t) (rng() % n), (uint32_t) (rng() % n),
+        weight(rng) };
+      edges.push_back(edge);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<CSRGraph::Edge> tree = Prim<uint32_t>::mst(CSRGraph(n, edges));
+    double primTime = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    bool minimum = MSTVerifier::isMinimum(n, edges, tree);
+    double verifyTime = secondsSince(start);
+
+    if (!minimum) {
+      std::cout << "Prim's tree was rejected" << std::endl;
+      return 1;
+    }
+    std::cout << density << "     " << primTime << "    " << verifyTime
+              << "    " << primTime / verifyTime << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,130 @@
+/*
+ * Parallel
+ *
+ * The small amount of threading the parallel MST engines need: split an
+ * index range into one contiguous chunk per thread and run them on
+ * std::threads, the calling thread taking the first chunk. sort builds on
+ * that: every thread sorts its own chunk, then neighbouring runs are
+ * merged pairwise, again one merge per thread, until one run is left.
+ * forEach is the pool for tasks of uneven size: the threads take indices
+ * one at a time off a shared atomic counter until none are left.
+ */
+
+#ifndef Parallel_Included
+#define Parallel_Included
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+class Parallel {
+  public:
+    // 0 means one thread per hardware thread
+    static inline size_t numThreads(size_t requested);
+
+    // calls fn(begin, end, thread) once per chunk of [0, count); ranges
+    // smaller than minChunk per thread use fewer threads
+    template <typename Function>
+    static void forChunks(size_t count, size_t numThreads, Function fn,
+                          size_t minChunk = 4096);
+
+    // calls fn(index, thread) once per index of [0, count), each thread
+    // taking the next unclaimed index whenever it is done with one
+    template <typename Function>
+    static void forEach(size_t count, size_t numThreads, Function fn);
+
+    template <typename Iterator, typename Compare>
+    static void sort(Iterator begin, Iterator end, Compare less,
+                     size_t numThreads);
+};
+
+inline size_t Parallel::numThreads(size_t requested) {
+  if (requested) return requested;
+  size_t hardware = std::thread::hardware_concurrency();
+  return hardware ? hardware : 1;
+}
+
+template <typename Function>
+void Parallel::forChunks(size_t count, size_t numThreads, Function fn,
+                         size_t minChunk) {
+  if (minChunk == 0) minChunk = 1;
+  if (numThreads > (count + minChunk - 1) / minChunk) {
+    numThreads = (count + minChunk - 1) / minChunk;
+  }
+  if (numThreads <= 1) {
+    if (count) fn((size_t) 0, count, (size_t) 0);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads - 1);
+  for (size_t t = 1; t < numThreads; ++t) {
+    threads.push_back(std::thread(fn, count * t / numThreads,
+                                  count * (t + 1) / numThreads, t));
+  }
+  fn((size_t) 0, count / numThreads, (size_t) 0);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+template <typename Function>
+void Parallel::forEach(size_t count, size_t numThreads, Function fn) {
+  // a thread per index at most, so one big task runs on the caller alone
+  numThreads = std::min(count, numThreads);
+  std::atomic<size_t> next(0);
+  forChunks(numThreads, numThreads,
+    [&](size_t, size_t, size_t thread) {
+      for (;;) {
+        size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= count) break;
+        fn(index, thread);
+      }
+    }, 1);
+}
+
+template <typename Iterator, typename Compare>
+void Parallel::sort(Iterator begin, Iterator end, Compare less,
+                    size_t numThreads) {
+  size_t count = end - begin;
+  // below this many elements per thread the merge rounds cost more than
+  // the split saves
+  const size_t minChunk = 1 << 16;
+  if (numThreads > (count + minChunk - 1) / minChunk) {
+    numThreads = (count + minChunk - 1) / minChunk;
+  }
+  if (numThreads <= 1) {
+    std::sort(begin, end, less);
+    return;
+  }
+
+  std::vector<size_t> bounds(numThreads + 1);
+  for (size_t t = 0; t <= numThreads; ++t) {
+    bounds[t] = count * t / numThreads;
+  }
+  forChunks(numThreads, numThreads,
+    [&](size_t first, size_t last, size_t) {
+      for (size_t t = first; t < last; ++t) {
+        std::sort(begin + bounds[t], begin + bounds[t + 1], less);
+      }
+    }, 1);
+
+  // each round merges runs [i, i + width) and [i + width, i + 2 width)
+  for (size_t width = 1; width < numThreads; width *= 2) {
+    size_t numMerges = (numThreads + 2 * width - 1) / (2 * width);
+    forChunks(numMerges, numMerges,
+      [&](size_t first, size_t last, size_t) {
+        for (size_t merge = first; merge < last; ++merge) {
+          size_t low = merge * 2 * width;
+          size_t middle = std::min(low + width, numThreads);
+          size_t high = std::min(low + 2 * width, numThreads);
+          std::inplace_merge(begin + bounds[low], begin + bounds[middle],
+                             begin + bounds[high], less);
+        }
+      }, 1);
+  }
+}
+
+#endif
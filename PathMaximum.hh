@@ -0,0 +1,166 @@
+/*
+ * Path Maximum
+ *
+ * Answers "what is the heaviest edge on the forest path between u and v"
+ * for a fixed spanning forest, which is what deciding F-heaviness needs:
+ * an edge (u, v, w) is F-heavy when u and v are connected in F and w is
+ * heavier than every edge on their path, so it can't be in the MST.
+ *
+ * Every tree is rooted and each vertex stores its 2^j-th ancestor together
+ * with the heaviest edge on the way there (binary lifting), so a query
+ * costs O(log n) after O(n log n) preprocessing. Edges are compared by
+ * (weight, origin), the same total order FlatDisjointSetForest uses.
+ *
+ * Test only: the engines filter F-heavy edges with MSTVerifier, and this
+ * stays as the simple reference MSTTester checks MSTVerifier against.
+ */
+
+#ifndef PathMaximum_Included
+#define PathMaximum_Included
+
+#include "FlatDisjointSetForest.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class PathMaximum {
+  public:
+    typedef FlatDisjointSetForest::Edge Edge;
+
+    // keeps a reference to forest, which has to outlive the queries
+    PathMaximum(size_t numVertices, const std::vector<Edge>& forest);
+    ~PathMaximum();
+
+    inline bool connected(uint32_t first, uint32_t second) const;
+    // position in the forest of the heaviest edge on the path, the two
+    // vertices must be connected and different
+    size_t maxEdge(uint32_t first, uint32_t second) const;
+    // true if edge can be discarded given the forest
+    inline bool isHeavy(const Edge& edge) const;
+
+  private:
+    static constexpr size_t NONE = SIZE_MAX;
+
+    const std::vector<Edge>& mForest;
+    size_t mLevels;
+    std::vector<uint32_t> mDepth;
+    std::vector<uint32_t> mTree;
+    // mUp[j][v] is the 2^j-th ancestor of v, mMax[j][v] the heaviest edge
+    // between v and that ancestor
+    std::vector<std::vector<uint32_t>> mUp;
+    std::vector<std::vector<size_t>> mMax;
+
+    inline size_t heavier(size_t one, size_t two) const;
+    static inline bool lighter(const Edge& one, const Edge& two);
+};
+
+inline PathMaximum::PathMaximum(size_t numVertices,
+    const std::vector<Edge>& forest) :
+  mForest(forest), mLevels(1), mDepth(numVertices, 0),
+  mTree(numVertices, UINT32_MAX) {
+  while (((size_t) 1 << mLevels) < numVertices) mLevels++;
+  mUp.assign(mLevels, std::vector<uint32_t>(numVertices));
+  mMax.assign(mLevels, std::vector<size_t>(numVertices, NONE));
+
+  // adjacency of the forest in CSR form
+  std::vector<size_t> offsets(numVertices + 1, 0);
+  for (const Edge& edge : forest) {
+    offsets[edge.first + 1]++;
+    offsets[edge.second + 1]++;
+  }
+  for (size_t v = 0; v < numVertices; ++v) offsets[v + 1] += offsets[v];
+  std::vector<size_t> incident(offsets[numVertices]);
+  std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+  for (size_t i = 0; i < forest.size(); ++i) {
+    incident[cursor[forest[i].first]++] = i;
+    incident[cursor[forest[i].second]++] = i;
+  }
+
+  // root every tree and record parents and depths breadth first
+  std::vector<uint32_t> queue;
+  queue.reserve(numVertices);
+  for (uint32_t root = 0; root < numVertices; ++root) {
+    if (mTree[root] != UINT32_MAX) continue;
+    mTree[root] = root;
+    mUp[0][root] = root;
+    queue.clear();
+    queue.push_back(root);
+    for (size_t head = 0; head < queue.size(); ++head) {
+      uint32_t v = queue[head];
+      for (size_t slot = offsets[v]; slot < offsets[v + 1]; ++slot) {
+        const Edge& edge = forest[incident[slot]];
+        uint32_t child = edge.first == v ? edge.second : edge.first;
+        if (mTree[child] != UINT32_MAX) continue;
+        mTree[child] = root;
+        mDepth[child] = mDepth[v] + 1;
+        mUp[0][child] = v;
+        mMax[0][child] = incident[slot];
+        queue.push_back(child);
+      }
+    }
+  }
+
+  for (size_t j = 1; j < mLevels; ++j) {
+    for (size_t v = 0; v < numVertices; ++v) {
+      uint32_t middle = mUp[j - 1][v];
+      mUp[j][v] = mUp[j - 1][middle];
+      mMax[j][v] = heavier(mMax[j - 1][v], mMax[j - 1][middle]);
+    }
+  }
+}
+
+inline PathMaximum::~PathMaximum() {
+  // Does nothing.
+}
+
+inline bool PathMaximum::lighter(const Edge& one, const Edge& two) {
+  return one.weight < two.weight ||
+    (one.weight == two.weight && one.origin < two.origin);
+}
+
+inline size_t PathMaximum::heavier(size_t one, size_t two) const {
+  if (one == NONE) return two;
+  if (two == NONE) return one;
+  return lighter(mForest[one], mForest[two]) ? two : one;
+}
+
+inline bool PathMaximum::connected(uint32_t first, uint32_t second) const {
+  return mTree[first] == mTree[second];
+}
+
+inline size_t PathMaximum::maxEdge(uint32_t first, uint32_t second) const {
+  size_t result = NONE;
+  if (mDepth[first] < mDepth[second]) {
+    uint32_t tmp = first;
+    first = second;
+    second = tmp;
+  }
+  // lift the deeper vertex to the depth of the other one
+  uint32_t gap = mDepth[first] - mDepth[second];
+  for (size_t j = 0; gap; ++j, gap >>= 1) {
+    if (gap & 1) {
+      result = heavier(result, mMax[j][first]);
+      first = mUp[j][first];
+    }
+  }
+  if (first == second) return result;
+  // then lift both to just below their lowest common ancestor
+  for (size_t j = mLevels; j-- > 0; ) {
+    if (mUp[j][first] != mUp[j][second]) {
+      result = heavier(result, heavier(mMax[j][first], mMax[j][second]));
+      first = mUp[j][first];
+      second = mUp[j][second];
+    }
+  }
+  return heavier(result, heavier(mMax[0][first], mMax[0][second]));
+}
+
+inline bool PathMaximum::isHeavy(const Edge& edge) const {
+  if (edge.first == edge.second || !connected(edge.first, edge.second)) {
+    return false;
+  }
+  return lighter(mForest[maxEdge(edge.first, edge.second)], edge);
+}
+
+#endif
@@ -0,0 +1,198 @@
+/*
+ * Pettie-Ramachandran
+ *
+ * A minimum spanning forest engine with the structure of Pettie and
+ * Ramachandran's optimal algorithm, where a lookup table of bounded size
+ * stands in for their decision trees. Each call
+ *
+ *  1. partitions the graph into subgraphs of at most four vertices by
+ *     growing them Prim-style out of a SoftHeap. An edge the heap ever
+ *     corrupted goes into the set M instead,
+ *  2. solves every subgraph minus M with a DecisionTree, giving the forest F,
+ *  3. contracts F, drops M and runs two Boruvka steps, picking F',
+ *  4. recursively computes the minimum spanning forest F_a of that,
+ *  5. forms G_b = F + F' + F_a + M, throws out the M edges that are heavy
+ *     with respect to the spanning forest F + F' + F_a, runs two Boruvka
+ *     steps on G_b and recurses on what is left.
+ *
+ * As with Chazelle, raising M to infinity gives a graph in which every
+ * subgraph is contractible, so F + F' + F_a is its MST and the MST of the
+ * input is inside G_b.
+ *
+ * Their bound, a constant factor off the optimal decision tree complexity
+ * of the MST problem, does not carry over, because three parts differ:
+ *
+ *  - their subgraphs grow to log log log n vertices, small enough to find
+ *    optimal decision trees for by brute force; here they stop at four,
+ *  - DecisionTree sorts a subgraph's six edge slots and looks the order up
+ *    in a table of 720 forests, which is no optimal comparison tree,
+ *  - the heavy edge filter is MSTVerifier, O(m alpha(m, n) + n log n)
+ *    rather than linear.
+ */
+
+#ifndef PettieRamachandran_Included
+#define PettieRamachandran_Included
+
+#include "UndirectedGraph.hh"
+#include "CSRGraph.hh"
+#include "InternedGraph.hh"
+#include "FlatDisjointSetForest.hh"
+#include "MSTVerifier.hh"
+#include "DecisionTree.hh"
+#include "SoftHeapPartition.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Heap is the soft heap policy SoftHeapPartition grows the subgraphs with
+template <typename T, typename Heap = SoftHeap<size_t> >
+class PettieRamachandran {
+  public:
+    // epsilon is the error rate of the soft heaps
+    static UndirectedGraph<T> mst(const UndirectedGraph<T>& graph,
+                                  double epsilon = 0.125);
+    static std::vector<CSRGraph::Edge> mst(const CSRGraph& graph,
+                                           double epsilon = 0.125);
+    static std::vector<CSRGraph::Edge> mst(size_t numVertices,
+        const std::vector<CSRGraph::Edge>& edges, double epsilon = 0.125);
+
+  private:
+    typedef SoftHeapPartition<Heap> Partition;
+    typedef typename Partition::Edge Edge;
+
+    // appends the minimum spanning forest of edges to result; only the
+    // origins of the appended edges are meaningful to the caller, position
+    // is scratch space indexed by origin
+    static void msf(size_t numVertices, const std::vector<Edge>& edges,
+                    std::vector<Edge>& result, std::vector<size_t>& position,
+                    size_t r);
+};
+
+template <typename T, typename Heap>
+UndirectedGraph<T> PettieRamachandran<T, Heap>::mst(
+    const UndirectedGraph<T>& graph, double epsilon) {
+  InternedGraph<T> interned(graph);
+  return interned.translate(mst(interned.getGraph(), epsilon));
+}
+
+template <typename T, typename Heap>
+std::vector<CSRGraph::Edge> PettieRamachandran<T, Heap>::mst(
+    const CSRGraph& graph, double epsilon) {
+  return mst(graph.size(), graph.edgeList(), epsilon);
+}
+
+template <typename T, typename Heap>
+std::vector<CSRGraph::Edge> PettieRamachandran<T, Heap>::mst(
+    size_t numVertices, const std::vector<CSRGraph::Edge>& edges,
+    double epsilon) {
+  std::vector<Edge> forest;
+  std::vector<size_t> position(edges.size());
+  msf(numVertices, Partition::tag(edges), forest, position,
+      Heap::rForEpsilon(epsilon));
+  return Partition::untag(edges, forest);
+}
+
+template <typename T, typename Heap>
+void PettieRamachandran<T, Heap>::msf(size_t numVertices,
+                                      const std::vector<Edge>& edges,
+                                      std::vector<Edge>& result,
+                                      std::vector<size_t>& position,
+                                      size_t r) {
+  const size_t baseCase = 1024;
+  if (edges.size() <= baseCase) {
+    Partition::kruskal(numVertices, edges, result);
+    return;
+  }
+
+  // drops parallel edges, which the decision trees can't take
+  FlatDisjointSetForest forest(numVertices, edges);
+  const std::vector<Edge>& level = forest.getEdges();
+  size_t size = forest.size();
+
+  // subgraphs of at most DecisionTree::MAX_VERTICES vertices; one that
+  // reaches an earlier subgraph stops there, and the edge stays between
+  Partition partition(size, level, r);
+  const std::vector<uint32_t>& subgraph = partition.getSubgraphs();
+  for (uint32_t source = 0; source < size; ++source) {
+    if (subgraph[source] == Partition::NONE) {
+      partition.grow(source, DecisionTree::MAX_VERTICES);
+    }
+  }
+  size_t numSubgraphs = partition.numSubgraphs();
+  const std::vector<uint8_t>& state = partition.getStates();
+
+  // the good edges inside each subgraph, by slot of their local endpoints
+  std::vector<uint8_t> local(size);
+  std::vector<uint8_t> members(numSubgraphs, 0);
+  for (size_t v = 0; v < size; ++v) local[v] = members[subgraph[v]]++;
+  std::vector<size_t> slots(numSubgraphs * DecisionTree::NUM_SLOTS);
+  std::vector<uint8_t> present(numSubgraphs, 0);
+  for (size_t i = 0; i < level.size(); ++i) {
+    const Edge& edge = level[i];
+    uint32_t s = subgraph[edge.first];
+    if (state[i] == Partition::BAD || s != subgraph[edge.second]) continue;
+    size_t slot = DecisionTree::slot(local[edge.first], local[edge.second]);
+    slots[s * DecisionTree::NUM_SLOTS + slot] = i;
+    present[s] |= 1 << slot;
+  }
+
+  std::vector<Edge> spanning;
+  for (size_t s = 0; s < numSubgraphs; ++s) {
+    if (!present[s]) continue;
+    double weights[DecisionTree::NUM_SLOTS];
+    size_t origins[DecisionTree::NUM_SLOTS];
+    for (size_t slot = 0; slot < DecisionTree::NUM_SLOTS; ++slot) {
+      if (!(present[s] >> slot & 1)) continue;
+      const Edge& edge = level[slots[s * DecisionTree::NUM_SLOTS + slot]];
+      weights[slot] = edge.weight;
+      origins[slot] = edge.origin;
+    }
+    uint8_t tree = DecisionTree::msf(weights, origins, present[s]);
+    for (size_t slot = 0; slot < DecisionTree::NUM_SLOTS; ++slot) {
+      if (tree >> slot & 1) {
+        spanning.push_back(level[slots[s * DecisionTree::NUM_SLOTS + slot]]);
+      }
+    }
+  }
+
+  // G_a: contract the subgraphs and leave out the bad edges
+  std::vector<Edge> contracted;
+  for (size_t i = 0; i < level.size(); ++i) {
+    if (state[i] == Partition::BAD) continue;
+    Edge edge = level[i];
+    edge.first = subgraph[edge.first];
+    edge.second = subgraph[edge.second];
+    if (edge.first != edge.second) contracted.push_back(edge);
+  }
+  FlatDisjointSetForest reduced(numSubgraphs, contracted);
+  contracted.clear();
+  contracted.shrink_to_fit();
+  std::vector<Edge> between;
+  for (int step = 0; step < 2 && reduced.numEdges() > 0; ++step) {
+    reduced.boruvkaStep(between);
+  }
+  msf(reduced.size(), reduced.getEdges(), between, position, r);
+
+  Partition::lookUp(level, between, spanning, position);
+
+  // G_b: the spanning forest of the graph without M, plus the edges of M
+  // it can't rule out
+  std::vector<Edge> corrupted;
+  for (size_t i = 0; i < level.size(); ++i) {
+    if (state[i] == Partition::BAD) corrupted.push_back(level[i]);
+  }
+  std::vector<uint8_t> heavy;
+  MSTVerifier(size, spanning).heavyEdges(corrupted, heavy);
+  std::vector<Edge> candidates(spanning);
+  for (size_t i = 0; i < corrupted.size(); ++i) {
+    if (!heavy[i]) candidates.push_back(corrupted[i]);
+  }
+  FlatDisjointSetForest remaining(size, candidates);
+  for (int step = 0; step < 2 && remaining.numEdges() > 0; ++step) {
+    remaining.boruvkaStep(result);
+  }
+  msf(remaining.size(), remaining.getEdges(), result, position, r);
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef Prim_Included
+#define Prim_Included
+
+#include "UndirectedGraph.hh"
+#include "CSRGraph.hh"
+#include "IndexedFibonacciHeap.hh"
+#include "IndexedDaryHeap.hh"
+#include "IndexedPairingHeap.hh"
+#include "IndexedBucketHeap.hh"
+#include "LazyHeap.hh"
+#include "InternedGraph.hh"
+
+#include <cstdint>
+#include <vector>
+
+// Queue is the priority queue policy, a heap over the vertex ids with the
+// interface of IndexedFibonacciHeap: a constructor taking the number of
+// ids, isEmpty, contains, getPriority of an id in the queue, findMin,
+// enqueue, extractMin returning the id and decreaseKey by id. Besides the
+// default there are IndexedDaryHeap, IndexedPairingHeap, LazyHeap,
+// which makes this lazy Prim without decrease-key, and for integer weights
+// IndexedBucketHeap, which throws std::invalid_argument on any other;
+// PrimBench times them against each other.
+template <typename T, typename Queue = IndexedFibonacciHeap>
+class Prim {
+public:
+	static UndirectedGraph<T> mst(const UndirectedGraph<T>& graph);
+	// returns the tree edges, grown from vertex 0; other components are left
+	// out, SpanningForest solves all of them
+	static std::vector<CSRGraph::Edge> mst(const CSRGraph& graph);
+	// runs on a graph that is never stored: neighbors(vertex, visit) calls
+	// visit(neighbor, weight) for every edge of vertex, each time it is asked,
+	// so memory stays linear in numVertices; for complete graphs given by a
+	// distance function DensePrim::complete is the better fit
+	template <typename Neighbors>
+	static std::vector<CSRGraph::Edge> mst(size_t numVertices,
+			Neighbors neighbors);
+};
+
+// interns the vertices once and runs on ids, so the inner loop never hashes
+template <typename T, typename Queue>
+UndirectedGraph<T> Prim<T, Queue>::mst(const UndirectedGraph<T>& graph) {
+	InternedGraph<T> interned(graph);
+	return interned.translate(mst(interned.getGraph()));
+}
+
+template <typename T, typename Queue>
+std::vector<CSRGraph::Edge> Prim<T, Queue>::mst(const CSRGraph& graph) {
+	return mst(graph.size(), [&](uint32_t node, auto visit) {
+		for (size_t slot = graph.offset(node); slot < graph.offset(node + 1);
+				 ++slot) {
+			visit(graph.neighbor(slot), graph.weight(slot));
+		}
+	});
+}
+
+template <typename T, typename Queue>
+template <typename Neighbors>
+std::vector<CSRGraph::Edge> Prim<T, Queue>::mst(size_t numVertices,
+		Neighbors neighbors) {
+	std::vector<CSRGraph::Edge> result;
+	if (numVertices == 0) return result;
+
+	// the heap is keyed by vertex id and the tree vertex each fringe vertex
+	// would attach to is indexed the same way, instead of a seen map
+	Queue pq(numVertices);
+	std::vector<uint32_t> connection(numVertices, 0);
+	std::vector<bool> inTree(numVertices, false);
+	result.reserve(numVertices - 1);
+
+	uint32_t node = 0;
+	inTree[node] = true;
+	for (;;) {
+		neighbors(node, [&](uint32_t endpoint, double weight) {
+			if (inTree[endpoint]) return;
+
+			if (!pq.contains(endpoint)) {
+				pq.enqueue(endpoint, weight);
+				connection[endpoint] = node;
+			} else if (weight < pq.getPriority(endpoint)) {
+				pq.decreaseKey(endpoint, weight);
+				connection[endpoint] = node;
+			}
+		});
+
+		if (pq.isEmpty()) break;
+
+		node = pq.findMin();
+		CSRGraph::Edge edge = { connection[node], node, pq.getPriority(node) };
+		pq.extractMin();
+		result.push_back(edge);
+		inTree[node] = true;
+	}
+
+	return result;
+}
+
+#endif
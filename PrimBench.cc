@@ -0,0 +1,83 @@
+/*
+ * Times Prim::mst with each priority queue policy on random connected
+ * graphs with a fixed vertex count and a growing edge density m/n, and
+ * names the fastest for each density. Weights are integers below
+ * maxWeight, at most IndexedBucketHeap::MAX_PRIORITY, so the bucket heap
+ * can run too.
+ *
+ * usage: PrimBench [vertices] [maxDensity] [maxWeight]
+ */
+
+#include "CSRGraph.hh"
+#include "Prim.hh"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// best of three runs, so a stray page fault doesn't pick the winner
+template <typename Queue>
+static double timePrim(const CSRGraph& graph, double& weight) {
+  double best = 0;
+  for (int run = 0; run < 3; run++) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<CSRGraph::Edge> tree = Prim<uint32_t, Queue>::mst(graph);
+    double time = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    if (run == 0 || time < best) best = time;
+    weight = 0;
+    for (const CSRGraph::Edge& edge : tree) weight += edge.weight;
+  }
+  return best;
+}
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 1000000;
+  size_t maxDensity = argc > 2 ? std::strtoull(argv[2], NULL, 10) : 32;
+  uint32_t maxWeight = argc > 3 ? std::strtoul(argv[3], NULL, 10) : 1 << 16;
+
+  const char *names[] = { "fibonacci", "4-ary", "pairing", "bucket", "lazy" };
+  std::cout << "vertices " << n << ", weights below " << maxWeight << std::endl;
+  std::cout << "m/n   fibonacci(s)  4-ary(s)    pairing(s)  bucket(s)   "
+            << "lazy(s)     fastest" << std::endl;
+  for (size_t density = 2; density <= maxDensity; density *= 2) {
+    std::mt19937_64 rng(density);
+    std::vector<CSRGraph::Edge> edges;
+    edges.reserve(density * n);
+    for (size_t i = 1; i < n; i++) {
+      CSRGraph::Edge edge = { (uint32_t) (rng() % i), (uint32_t) i,
+        (double) (rng() % maxWeight) };
+      edges.push_back(edge);
+    }
+    while (edges.size() < density * n) {
+      CSRGraph::Edge edge = { (uint32_t) (rng() % n), (uint32_t) (rng() % n),
+        (double) (rng() % maxWeight) };
+      edges.push_back(edge);
+    }
+    CSRGraph graph(n, edges);
+
+    double weights[5];
+    double times[5] = {
+      timePrim<IndexedFibonacciHeap>(graph, weights[0]),
+      timePrim<IndexedDaryHeap<4> >(graph, weights[1]),
+      timePrim<IndexedPairingHeap>(graph, weights[2]),
+      timePrim<IndexedBucketHeap>(graph, weights[3]),
+      timePrim<LazyHeap>(graph, weights[4])
+    };
+    size_t fastest = 0;
+    for (size_t i = 0; i < 5; i++) {
+      if (weights[i] != weights[0]) {
+        std::cout << names[i] << " found a different tree weight" << std::endl;
+        return 1;
+      }
+      if (times[i] < times[fastest]) fastest = i;
+    }
+    std::cout << density << "     " << times[0] << "      " << times[1]
+              << "    " << times[2] << "    " << times[3] << "    "
+              << times[4] << "    " << names[fastest] << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,552 @@
+/*
+ * Simplified Soft Heap
+ *
+ * The soft heap of Kaplan, Tarjan and Zwick's "Soft heaps simplified",
+ * behind the same interface as SoftHeap so the two engines can stand in for
+ * each other. Every tree is a binary tree whose nodes carry a car pool, a
+ * circular list of entries that all travel under the node's key, which is
+ * at least the largest of their keys. There are no target list sizes and
+ * no tree objects:
+ *
+ *  - linking two roots of rank k makes an empty root of rank k + 1 and fills
+ *    it: the pool of the child with the smaller key moves up, and the child
+ *    is refilled the same way, or dropped if it was a leaf;
+ *  - above rank r, nodes of odd rank are filled twice, which is the only
+ *    place entries get corrupted and what keeps them below epsilon;
+ *  - extract_min takes an entry off the pool of the root with the least key
+ *    and refills the root only once its pool runs dry.
+ *
+ * The roots form a singly linked list of increasing rank, each pointing at
+ * the root of least key from itself on, and both links live on the nodes.
+ * Entries and nodes come from slab allocators, as in SoftHeap.
+ */
+
+#ifndef SimplifiedSoftHeap_Included
+#define SimplifiedSoftHeap_Included
+
+#include "SlabAllocator.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+template <typename T>
+class SimplifiedSoftHeap {
+  public:
+    struct Entry {
+      Entry(const double key, const T& value);
+
+      double mKey;
+      T mValue;
+      Entry *next;
+    };
+
+    // the corrupted and the extracted entries, laid out as in SoftHeap
+    struct EntryList {
+      EntryList();
+
+      size_t size;
+      Entry *head;
+      Entry *tail;
+
+      void concatenate(EntryList *other);
+      void add(Entry *entry);
+    };
+
+    SimplifiedSoftHeap();
+    explicit SimplifiedSoftHeap(const double epsilon);
+    ~SimplifiedSoftHeap();
+
+    // r for error rate epsilon, ceil(log2(3 / epsilon)) as in Kaplan, Tarjan
+    // and Zwick; smaller than SoftHeap's, whose ranks count differently
+    static inline size_t rForEpsilon(const double epsilon);
+
+    // empties the heap, corrupted and extracted entries included, keeping
+    // the slabs and r for the next elements
+    void clear();
+
+    inline size_t getR() const;
+    inline void setR(const size_t newR);
+    inline size_t getSize() const;
+    inline bool isEmpty() const;
+
+    inline EntryList *getCorrupted();
+    // the ckey the next extract_min will return its element under
+    inline double getMinCkey() const;
+
+    // the same counters as SoftHeap's; a fill counts as a sift
+    inline size_t getInserts() const;
+    inline size_t getSifts() const;
+    inline size_t getCorruptions() const;
+    inline size_t getCorruptedInHeap() const;
+    inline double getCorruptionRatio() const;
+
+    Entry *extract_min(); // DON'T FREE THESE, handled by heap destructor
+    void insert(const double key, const T& value);
+    // fill the heap from pairs of key and value, as SoftHeap's do
+    template <typename Iterator>
+    void build(Iterator begin, Iterator end);
+    template <typename Iterator>
+    void insertBatch(Iterator begin, Iterator end);
+    // entries extracted from p stay valid as long as this heap
+    void meld(SimplifiedSoftHeap<T>& p);
+
+  private:
+    struct Node {
+      double key;
+      size_t rank;
+      Node *left;
+      Node *right;
+      // the last entry of the car pool, whose next is the first
+      Entry *items;
+      // the entry whose key is key, NULL once it has been extracted
+      Entry *keyItem;
+      // only used on roots
+      Node *next;
+      Node *suffixMin;
+    };
+
+    // a root of rank k holds up to 2^k elements, so no heap has a root of
+    // rank 64 and ranks along the root list increase
+    static constexpr size_t MAX_ROOTS = 64;
+
+    size_t mR;
+    size_t mSize;
+    size_t mInserts;
+    size_t mSifts;
+    size_t mCorruptedInHeap;
+    size_t heapRank;
+    Node *first;
+
+    EntryList corrupted;
+    EntryList returned;
+
+    SlabAllocator<Entry> entryPool;
+    SlabAllocator<Node> nodePool;
+    // insertBatch's nodes waiting for one of equal rank
+    std::vector<Node *> batchNodes;
+
+    inline Node *new_leaf(const double key, const T& value);
+    Node *link(Node *one, Node *two);
+    void defill(Node *node);
+    void fill(Node *node);
+    static inline Entry *concatenate(Entry *one, Entry *two);
+
+    // merges a root list of increasing rank, with its suffix mins set, into
+    // ours, linking roots of equal rank as binary addition carries
+    void merge_roots(Node *list, size_t listRank);
+    // resets the suffix mins of path[depth - 1] back to path[0], each of
+    // which must be the root before the next
+    static void update_suffix_min(Node **path, size_t depth);
+
+    void destroy_entries();
+    void destroy_entries(EntryList& list);
+
+    SimplifiedSoftHeap(SimplifiedSoftHeap const &) = delete;
+    void operator=(SimplifiedSoftHeap const &) = delete;
+};
+
+template <typename T>
+SimplifiedSoftHeap<T>::Entry::Entry(const double key, const T& value) :
+  mKey(key), mValue(value), next(NULL) {
+  // Handled in initializer list.
+}
+
+template <typename T>
+SimplifiedSoftHeap<T>::EntryList::EntryList() : size(0), head(NULL),
+  tail(NULL) {
+  // Handled in initializer list.
+}
+
+// puts other in front of this list and empties it
+template <typename T>
+void SimplifiedSoftHeap<T>::EntryList::concatenate(EntryList *other) {
+  if (other->size == 0) return;
+  other->tail->next = head;
+  head = other->head;
+  if (!tail) tail = other->tail;
+  size += other->size;
+  other->size = 0;
+  other->head = other->tail = NULL;
+}
+
+template <typename T>
+void SimplifiedSoftHeap<T>::EntryList::add(Entry *entry) {
+  entry->next = head;
+  head = entry;
+  if (!tail) tail = entry;
+  size++;
+}
+
+template <typename T>
+SimplifiedSoftHeap<T>::SimplifiedSoftHeap() : mR(0), mSize(0),
+  mInserts(0), mSifts(0), mCorruptedInHeap(0), heapRank(0), first(NULL) {
+  // Handled in initializer list.
+}
+
+template <typename T>
+SimplifiedSoftHeap<T>::SimplifiedSoftHeap(const double epsilon) :
+  mR(rForEpsilon(epsilon)), mSize(0), mInserts(0), mSifts(0),
+  mCorruptedInHeap(0), heapRank(0), first(NULL) {
+  // Handled in initializer list.
+}
+
+template <typename T>
+SimplifiedSoftHeap<T>::~SimplifiedSoftHeap() {
+  destroy_entries();
+}
+
+template <typename T>
+inline size_t SimplifiedSoftHeap<T>::rForEpsilon(const double epsilon) {
+  assert(epsilon > 0 && epsilon < 1);
+  return (size_t) std::ceil(std::log2(3.0 / epsilon));
+}
+
+template <typename T>
+void SimplifiedSoftHeap<T>::clear() {
+  destroy_entries();
+  entryPool.reset();
+  nodePool.reset();
+  corrupted = EntryList();
+  returned = EntryList();
+  first = NULL;
+  mSize = 0;
+  heapRank = 0;
+  mInserts = 0;
+  mSifts = 0;
+  mCorruptedInHeap = 0;
+}
+
+template <typename T>
+inline size_t SimplifiedSoftHeap<T>::getR() const { return mR; }
+
+template <typename T>
+inline void SimplifiedSoftHeap<T>::setR(const size_t newR) { mR = newR; }
+
+template <typename T>
+inline size_t SimplifiedSoftHeap<T>::getSize() const { return mSize; }
+
+template <typename T>
+inline bool SimplifiedSoftHeap<T>::isEmpty() const { return mSize == 0; }
+
+template <typename T>
+inline typename SimplifiedSoftHeap<T>::EntryList *
+SimplifiedSoftHeap<T>::getCorrupted() {
+  return &corrupted;
+}
+
+template <typename T>
+inline double SimplifiedSoftHeap<T>::getMinCkey() const {
+  assert(first);
+  return first->suffixMin->key;
+}
+
+template <typename T>
+inline size_t SimplifiedSoftHeap<T>::getInserts() const { return mInserts; }
+
+template <typename T>
+inline size_t SimplifiedSoftHeap<T>::getSifts() const { return mSifts; }
+
+template <typename T>
+inline size_t SimplifiedSoftHeap<T>::getCorruptions() const {
+  return corrupted.size;
+}
+
+template <typename T>
+inline size_t SimplifiedSoftHeap<T>::getCorruptedInHeap() const {
+  return mCorruptedInHeap;
+}
+
+template <typename T>
+inline double SimplifiedSoftHeap<T>::getCorruptionRatio() const {
+  return mInserts ? (double) mCorruptedInHeap / mInserts : 0;
+}
+
+template <typename T>
+typename SimplifiedSoftHeap<T>::Entry *SimplifiedSoftHeap<T>::extract_min() {
+  assert(first);
+  mSize--;
+  Node *node = first->suffixMin;
+  Entry *entry = node->items->next;
+  if (entry == node->items) {
+    node->items = NULL;
+  } else {
+    node->items->next = entry->next;
+  }
+  if (entry == node->keyItem) {
+    node->keyItem = NULL;
+  } else {
+    mCorruptedInHeap--;
+  }
+  returned.add(entry);
+  if (node->items) return entry;
+
+  // the pool ran dry: refill the root, or drop it if it was a leaf, then
+  // fix the suffix mins up to where it was
+  Node *path[MAX_ROOTS];
+  size_t depth = 0;
+  for (Node *root = first; root != node; root = root->next) {
+    path[depth++] = root;
+  }
+  if (node->left) {
+    defill(node);
+    path[depth++] = node;
+  } else {
+    if (depth) {
+      path[depth - 1]->next = node->next;
+    } else {
+      first = node->next;
+    }
+    if (!node->next) heapRank = depth ? path[depth - 1]->rank : 0;
+    nodePool.deallocate(node);
+  }
+  update_suffix_min(path, depth);
+  return entry;
+}
+
+template <typename T>
+void SimplifiedSoftHeap<T>::insert(const double key, const T& value) {
+  mSize++;
+  mInserts++;
+  merge_roots(new_leaf(key, value), 0);
+}
+
+template <typename T>
+template <typename Iterator>
+void SimplifiedSoftHeap<T>::build(Iterator begin, Iterator end) {
+  assert(isEmpty());
+  insertBatch(begin, end);
+}
+
+// links the leaves as a binary counter carries, as SoftHeap::insertBatch
+// does, and merges what is left into the root list in one go
+template <typename T>
+template <typename Iterator>
+void SimplifiedSoftHeap<T>::insertBatch(Iterator begin, Iterator end) {
+  batchNodes.clear();
+  size_t count = 0;
+  for (Iterator it = begin; it != end; ++it, ++count) {
+    Node *node = new_leaf(it->first, it->second);
+    while (!batchNodes.empty() && batchNodes.back()->rank == node->rank) {
+      node = link(batchNodes.back(), node);
+      batchNodes.pop_back();
+    }
+    batchNodes.push_back(node);
+  }
+  if (count == 0) return;
+  mSize += count;
+  mInserts += count;
+
+  // the stack holds the roots in decreasing rank from the bottom
+  for (size_t i = batchNodes.size() - 1; i > 0; --i) {
+    batchNodes[i]->next = batchNodes[i - 1];
+  }
+  std::reverse(batchNodes.begin(), batchNodes.end());
+  update_suffix_min(batchNodes.data(), batchNodes.size());
+  merge_roots(batchNodes.front(), batchNodes.back()->rank);
+}
+
+template <typename T>
+void SimplifiedSoftHeap<T>::meld(SimplifiedSoftHeap<T>& p) {
+  if (&p == this) return;
+  if (p.first) {
+    mSize += p.mSize;
+    merge_roots(p.first, p.heapRank);
+  }
+  p.first = NULL;
+  p.mSize = 0;
+  p.heapRank = 0;
+
+  // p's extracted and corrupted entries and its memory come along
+  corrupted.concatenate(&p.corrupted);
+  returned.concatenate(&p.returned);
+  mInserts += p.mInserts;
+  mSifts += p.mSifts;
+  mCorruptedInHeap += p.mCorruptedInHeap;
+  p.mInserts = p.mSifts = p.mCorruptedInHeap = 0;
+  entryPool.absorb(p.entryPool);
+  nodePool.absorb(p.nodePool);
+}
+
+template <typename T>
+inline typename SimplifiedSoftHeap<T>::Node *
+SimplifiedSoftHeap<T>::new_leaf(const double key, const T& value) {
+  Entry *entry = new (entryPool.allocate()) Entry(key, value);
+  entry->next = entry;
+  Node *node = new (nodePool.allocate()) Node();
+  node->key = key;
+  node->items = node->keyItem = entry;
+  node->suffixMin = node;
+  return node;
+}
+
+template <typename T>
+typename SimplifiedSoftHeap<T>::Node *SimplifiedSoftHeap<T>::link(
+    Node *one, Node *two) {
+  Node *node = new (nodePool.allocate()) Node();
+  node->key = std::numeric_limits<double>::infinity();
+  node->rank = one->rank + 1;
+  node->left = one;
+  node->right = two;
+  node->suffixMin = node;
+  defill(node);
+  return node;
+}
+
+template <typename T>
+void SimplifiedSoftHeap<T>::defill(Node *node) {
+  fill(node);
+  if (node->rank > mR && node->rank % 2 == 1 && node->left) fill(node);
+}
+
+// moves the pool of the child with the smaller key up into node, which
+// must have a left child
+template <typename T>
+void SimplifiedSoftHeap<T>::fill(Node *node) {
+  mSifts++;
+  if (node->right && node->right->key < node->left->key) {
+    std::swap(node->left, node->right);
+  }
+  Node *child = node->left;
+  // what node still holds goes on under the child's larger key, and the
+  // one entry that had node's key is corrupted by that
+  if (node->items && node->keyItem) {
+    corrupted.add(new (entryPool.allocate())
+                  Entry(node->keyItem->mKey, node->keyItem->mValue));
+    mCorruptedInHeap++;
+  }
+  node->key = child->key;
+  node->items = concatenate(node->items, child->items);
+  node->keyItem = child->keyItem;
+  child->items = child->keyItem = NULL;
+
+  if (!child->left) {
+    nodePool.deallocate(child);
+    node->left = node->right;
+    node->right = NULL;
+  } else {
+    defill(child);
+  }
+}
+
+// joins two car pools given by their last entries, returning the last one
+template <typename T>
+inline typename SimplifiedSoftHeap<T>::Entry *
+SimplifiedSoftHeap<T>::concatenate(Entry *one, Entry *two) {
+  if (!one) return two;
+  if (!two) return one;
+  std::swap(one->next, two->next);
+  return two;
+}
+
+template <typename T>
+void SimplifiedSoftHeap<T>::merge_roots(Node *list, size_t listRank) {
+  if (!first) {
+    first = list;
+    heapRank = listRank;
+    return;
+  }
+
+  // the two lists merged by rank, the new roots first among equals
+  size_t k = std::min(heapRank, listRank);
+  Node *ours = first;
+  Node *last = NULL;
+  while (list || ours) {
+    Node *root;
+    if (!ours || (list && list->rank <= ours->rank)) {
+      root = list;
+      list = list->next;
+    } else {
+      root = ours;
+      ours = ours->next;
+    }
+    if (last) {
+      last->next = root;
+    } else {
+      first = root;
+    }
+    last = root;
+  }
+  last->next = NULL;
+  heapRank = std::max(heapRank, listRank);
+
+  // link equal ranks, the last two of three; past rank k with nothing to
+  // link, the rest is one list untouched, suffix mins and all
+  Node *path[MAX_ROOTS];
+  size_t depth = 0;
+  Node *root = first;
+  while (root->next) {
+    Node *next = root->next;
+    if (root->rank != next->rank ||
+        (next->next && next->next->rank == root->rank)) {
+      if (root->rank > k) break;
+      path[depth++] = root;
+      root = next;
+      continue;
+    }
+    Node *linked = link(root, next);
+    linked->next = next->next;
+    if (depth) {
+      path[depth - 1]->next = linked;
+    } else {
+      first = linked;
+    }
+    root = linked;
+  }
+  if (root->rank > heapRank) heapRank = root->rank;
+  path[depth++] = root;
+  update_suffix_min(path, depth);
+}
+
+template <typename T>
+void SimplifiedSoftHeap<T>::update_suffix_min(Node **path, size_t depth) {
+  for (size_t i = depth; i-- > 0;) {
+    Node *root = path[i];
+    if (root->next && root->next->suffixMin->key < root->key) {
+      root->suffixMin = root->next->suffixMin;
+    } else {
+      root->suffixMin = root;
+    }
+  }
+}
+
+template <typename T>
+void SimplifiedSoftHeap<T>::destroy_entries() {
+  if (std::is_trivially_destructible<T>::value) return;
+  std::vector<Node *> stack;
+  for (Node *root = first; root; root = root->next) {
+    stack.push_back(root);
+    while (!stack.empty()) {
+      Node *node = stack.back();
+      stack.pop_back();
+      if (node->items) {
+        Entry *entry = node->items->next;
+        node->items->next = NULL;
+        while (entry) {
+          Entry *next = entry->next;
+          entry->~Entry();
+          entry = next;
+        }
+      }
+      if (node->left) stack.push_back(node->left);
+      if (node->right) stack.push_back(node->right);
+    }
+  }
+  destroy_entries(corrupted);
+  destroy_entries(returned);
+}
+
+template <typename T>
+void SimplifiedSoftHeap<T>::destroy_entries(EntryList& list) {
+  for (Entry *entry = list.head; entry;) {
+    Entry *next = entry->next;
+    entry->~Entry();
+    entry = next;
+  }
+}
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Single Linkage
+ *
+ * Single-linkage hierarchical clustering read straight off a minimum
+ * spanning forest: merging its edges lightest first is exactly the order
+ * in which single linkage joins clusters, at the edge's weight. The merges
+ * come out as a compact linkage array in the usual layout, where clusters
+ * 0 to n - 1 are the vertices and merge i creates cluster n + i out of
+ * left and right, size vertices in all, at height. The union-find is the
+ * repo's FlatDisjointSet.
+ *
+ * Stopping at k clusters only needs the n - k lightest edges, so those are
+ * selected with nth_element and only they are sorted. clusters labels each
+ * vertex with its cluster at that cut and doesn't sort at all, since the
+ * cut is the same whatever order its edges are merged in.
+ */
+
+#ifndef SingleLinkage_Included
+#define SingleLinkage_Included
+
+#include "CSRGraph.hh"
+#include "FlatDisjointSet.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class SingleLinkage {
+  public:
+    struct Merge {
+      uint32_t left;
+      uint32_t right;
+      double height;
+      uint32_t size;
+    };
+
+    // forest must be a minimum spanning forest of the vertices 0 to
+    // numVertices - 1, such as any engine here returns; the merges stop
+    // once numClusters clusters are left, or the forest runs out of edges
+    static std::vector<Merge> linkage(size_t numVertices,
+        std::vector<CSRGraph::Edge> forest, size_t numClusters = 1);
+    // the cluster of each vertex, numbered 0 up in order of each cluster's
+    // lowest vertex, once the same merges leave numClusters clusters
+    static std::vector<uint32_t> clusters(size_t numVertices,
+        std::vector<CSRGraph::Edge> forest, size_t numClusters);
+
+  private:
+    // moves the lightest merges needed for numClusters to the front of
+    // forest, in no particular order, and returns how many there are
+    static size_t lightest(size_t numVertices,
+        std::vector<CSRGraph::Edge>& forest, size_t numClusters);
+    static inline bool lighter(const CSRGraph::Edge& one,
+                               const CSRGraph::Edge& two);
+};
+
+inline bool SingleLinkage::lighter(const CSRGraph::Edge& one,
+                                   const CSRGraph::Edge& two) {
+  return one.weight < two.weight;
+}
+
+inline size_t SingleLinkage::lightest(size_t numVertices,
+    std::vector<CSRGraph::Edge>& forest, size_t numClusters) {
+  size_t merges = numVertices > numClusters ? numVertices - numClusters : 0;
+  if (merges > forest.size()) merges = forest.size();
+  if (merges < forest.size()) {
+    std::nth_element(forest.begin(), forest.begin() + merges, forest.end(),
+                     lighter);
+  }
+  return merges;
+}
+
+inline std::vector<SingleLinkage::Merge> SingleLinkage::linkage(
+    size_t numVertices, std::vector<CSRGraph::Edge> forest,
+    size_t numClusters) {
+  size_t merges = lightest(numVertices, forest, numClusters);
+  std::sort(forest.begin(), forest.begin() + merges, lighter);
+  std::vector<Merge> result;
+  result.reserve(merges);
+
+  // the linkage id of the cluster each union-find root stands for
+  FlatDisjointSet sets(numVertices);
+  std::vector<uint32_t> cluster(numVertices);
+  for (size_t i = 0; i < numVertices; ++i) cluster[i] = i;
+  for (size_t i = 0; i < merges; ++i) {
+    uint32_t first = sets.find(forest[i].first);
+    uint32_t second = sets.find(forest[i].second);
+    uint32_t left = std::min(cluster[first], cluster[second]);
+    uint32_t right = std::max(cluster[first], cluster[second]);
+    uint32_t root = sets.unionSets(first, second);
+    cluster[root] = numVertices + i;
+    Merge merge = { left, right, forest[i].weight, sets.setSize(root) };
+    result.push_back(merge);
+  }
+  return result;
+}
+
+inline std::vector<uint32_t> SingleLinkage::clusters(size_t numVertices,
+    std::vector<CSRGraph::Edge> forest, size_t numClusters) {
+  size_t merges = lightest(numVertices, forest, numClusters);
+  FlatDisjointSet sets(numVertices);
+  for (size_t i = 0; i < merges; ++i) {
+    sets.unionSets(forest[i].first, forest[i].second);
+  }
+
+  const uint32_t NONE = UINT32_MAX;
+  std::vector<uint32_t> label(numVertices, NONE);
+  std::vector<uint32_t> result(numVertices);
+  uint32_t next = 0;
+  for (size_t i = 0; i < numVertices; ++i) {
+    uint32_t root = sets.find(i);
+    if (label[root] == NONE) label[root] = next++;
+    result[i] = label[root];
+  }
+  return result;
+}
+
+#endif
@@ -0,0 +1,173 @@
+/*
+ * Slab Allocator
+ *
+ * Allocation policies for the node based heaps. A policy hands out raw,
+ * suitably aligned memory for one Node at a time and takes it back; the
+ * heap placement-constructs and destroys the Node itself.
+ *
+ * SlabAllocator carves nodes out of slabs that double in size up to
+ * MAX_SLAB nodes, so consecutive allocations sit next to each other. Freed
+ * nodes go onto a free list threaded through their own memory and are
+ * handed out again first. Every slab is released at once when the
+ * allocator is destroyed, whatever is still allocated from it, and reset
+ * takes every node back at once while keeping the slabs for reuse.
+ *
+ * NewDeleteAllocator is plain operator new and delete per node, for
+ * comparison.
+ */
+
+#ifndef SlabAllocator_Included
+#define SlabAllocator_Included
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+template <typename Node>
+class SlabAllocator {
+  public:
+    static constexpr size_t MIN_SLAB = 64;
+    static constexpr size_t MAX_SLAB = 1 << 16;
+
+    SlabAllocator();
+    ~SlabAllocator();
+
+    inline void *allocate();
+    inline void deallocate(void *node);
+    // takes over every slab of other, which is left empty; nodes allocated
+    // from other stay valid and are now released by this allocator
+    void absorb(SlabAllocator<Node>& other);
+    // frees every node without destroying it; the slabs are handed out
+    // again from the first
+    void reset();
+
+  private:
+    // a freed node's memory holds the next free node
+    struct FreeNode {
+      FreeNode *mNext;
+    };
+
+    union Cell {
+      FreeNode free;
+      alignas(Node) char node[sizeof(Node)];
+    };
+
+    struct Slab {
+      Cell *mCells;
+      size_t mSize;
+    };
+
+    // the first mUsed slabs have been handed out, the rest are spare
+    std::vector<Slab> mSlabs;
+    size_t mUsed;
+    Cell *mCursor;
+    Cell *mEnd;
+    FreeNode *mFree;
+    size_t mNextSlab;
+
+    void grow();
+
+    SlabAllocator(SlabAllocator const &) = delete;
+    void operator=(SlabAllocator const &) = delete;
+};
+
+template <typename Node>
+class NewDeleteAllocator {
+  public:
+    inline void *allocate();
+    inline void deallocate(void *node);
+    inline void absorb(NewDeleteAllocator<Node>& other);
+};
+
+template <typename Node>
+SlabAllocator<Node>::SlabAllocator() : mUsed(0), mCursor(NULL), mEnd(NULL),
+  mFree(NULL), mNextSlab(MIN_SLAB) {
+  // Handled in initializer list.
+}
+
+template <typename Node>
+SlabAllocator<Node>::~SlabAllocator() {
+  for (const Slab& slab : mSlabs) {
+    ::operator delete(slab.mCells);
+  }
+}
+
+template <typename Node>
+inline void *SlabAllocator<Node>::allocate() {
+  if (mFree) {
+    FreeNode *node = mFree;
+    mFree = node->mNext;
+    return node;
+  }
+  if (mCursor == mEnd) grow();
+  return mCursor++;
+}
+
+template <typename Node>
+inline void SlabAllocator<Node>::deallocate(void *node) {
+  FreeNode *free = static_cast<FreeNode *>(node);
+  free->mNext = mFree;
+  mFree = free;
+}
+
+template <typename Node>
+void SlabAllocator<Node>::grow() {
+  if (mUsed == mSlabs.size()) {
+    Slab slab = {
+      static_cast<Cell *>(::operator new(mNextSlab * sizeof(Cell))), mNextSlab
+    };
+    mSlabs.push_back(slab);
+    if (mNextSlab < MAX_SLAB) mNextSlab *= 2;
+  }
+  mCursor = mSlabs[mUsed].mCells;
+  mEnd = mCursor + mSlabs[mUsed].mSize;
+  mUsed++;
+}
+
+template <typename Node>
+void SlabAllocator<Node>::absorb(SlabAllocator<Node>& other) {
+  if (&other == this) return;
+  // other's slabs in use join ours in use, so spare slabs stay at the end
+  mSlabs.insert(mSlabs.begin() + mUsed, other.mSlabs.begin(),
+                other.mSlabs.begin() + other.mUsed);
+  mSlabs.insert(mSlabs.end(), other.mSlabs.begin() + other.mUsed,
+                other.mSlabs.end());
+  mUsed += other.mUsed;
+  // the rest of other's current slab would be lost, so hand it out as free
+  // nodes along with other's free list
+  for (Cell *cell = other.mCursor; cell != other.mEnd; ++cell) {
+    deallocate(cell);
+  }
+  while (other.mFree) {
+    FreeNode *node = other.mFree;
+    other.mFree = node->mNext;
+    deallocate(node);
+  }
+  other.mSlabs.clear();
+  other.mUsed = 0;
+  other.mCursor = other.mEnd = NULL;
+}
+
+template <typename Node>
+void SlabAllocator<Node>::reset() {
+  mUsed = 0;
+  mCursor = mEnd = NULL;
+  mFree = NULL;
+}
+
+template <typename Node>
+inline void *NewDeleteAllocator<Node>::allocate() {
+  return ::operator new(sizeof(Node));
+}
+
+template <typename Node>
+inline void NewDeleteAllocator<Node>::deallocate(void *node) {
+  ::operator delete(node);
+}
+
+template <typename Node>
+inline void NewDeleteAllocator<Node>::absorb(NewDeleteAllocator<Node>&) {
+  // Does nothing.
+}
+
+#endif
@@ -1,9 +1,20 @@
 #ifndef SoftHeap_Included
 #define SoftHeap_Included
 
+#include "SlabAllocator.hh"
+
 #include <vector>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
+#include <type_traits>
+
+// Entries, nodes and trees all come from slab allocators the heap owns, so
+// inserting and sifting allocate only when a slab runs out, and destroying
+// or clearing the heap gives every slab back at once instead of freeing
+// the trees node by node. Melding hands the other heap's slabs over along
+// with its trees.
 
 template <typename T>
 class SoftHeap {
@@ -11,8 +22,18 @@ class SoftHeap {
 
     SoftHeap();
     SoftHeap(const double key, const T& value, const size_t r);
+    // a heap with the r that keeps corruption under the error rate epsilon
+    explicit SoftHeap(const double epsilon);
     ~SoftHeap();
 
+    // r for error rate epsilon, ceil(log2(1 / epsilon)) + 5 as in Kaplan and
+    // Zwick's simpler implementation of Chazelle's soft heap
+    static inline size_t rForEpsilon(const double epsilon);
+
+    // empties the heap, corrupted and extracted entries included, keeping
+    // the slabs and r for the next elements
+    void clear();
+
     struct Entry {
       Entry(const double key, const T& value);
       ~Entry();
@@ -36,7 +57,7 @@ class SoftHeap {
     };
 
     struct Node {
-      Node(const double key, const T& value);
+      Node(Entry *entry);
       Node();
       ~Node();
 
@@ -46,11 +67,11 @@ class SoftHeap {
       size_t size;
       Node* left;
       Node* right;
-      EntryList *entryList;
+      EntryList entryList;
     };
 
     struct Tree {
-      Tree(const double key, const T& value);
+      Tree(Node *node);
       ~Tree();
 
       Node* root;
@@ -72,9 +93,31 @@ class SoftHeap {
     inline bool isEmpty() const;
 
     inline EntryList *getCorrupted(); // maybe should return constant somehow?
+    // the ckey the next extract_min will return its element under, an
+    // element extracted with a smaller key than this was corrupted
+    inline double getMinCkey() const;
+
+    // counts since construction or the last clear, melded heaps included
+    inline size_t getInserts() const;
+    inline size_t getSifts() const;
+    // elements ever corrupted, the size of getCorrupted()
+    inline size_t getCorruptions() const;
+    // corrupted elements not extracted yet
+    inline size_t getCorruptedInHeap() const;
+    // getCorruptedInHeap() over getInserts(), which r keeps below epsilon
+    inline double getCorruptionRatio() const;
 
     Entry *extract_min(); // DON'T FREE THESE, handled by heap destructor
     void insert(const double key, const T& value);
+    // fills an empty heap from pairs of key and value, building the trees
+    // bottom-up without a root list to maintain, in linear time
+    template <typename Iterator>
+    void build(Iterator begin, Iterator end);
+    // the same for a heap that may hold elements: the batch's trees are
+    // built apart and merged into the root list all at once
+    template <typename Iterator>
+    void insertBatch(Iterator begin, Iterator end);
+    // entries extracted from p stay valid as long as this heap
     void meld(SoftHeap<T>& p);
 
 
@@ -84,13 +127,36 @@ class SoftHeap {
 
     size_t mR;
     size_t mSize;
+    size_t mInserts;
+    size_t mSifts;
+    size_t mCorruptedInHeap;
     size_t heapRank;
     Tree* first;
 
-    EntryList *corrupted;
+    EntryList corrupted;
+    // extracted entries, kept so the caller's pointers stay valid until the
+    // heap is destroyed
+    EntryList returned;
+
+    SlabAllocator<Entry> entryPool;
+    SlabAllocator<Node> nodePool;
+    SlabAllocator<Tree> treePool;
+    // insertBatch's nodes waiting for one of equal rank
+    std::vector<Node *> batchNodes;
 
     inline bool is_leaf(Node *node) const;
 
+    inline Node *new_leaf(const double key, const T& value);
+    inline Tree *new_tree(const double key, const T& value);
+    inline void free_node(Node *node);
+    inline void free_tree(Tree *tree);
+    // destroys the values of every entry the heap still holds, only needed
+    // when T has a destructor
+    void destroy_entries();
+    void destroy_entries(EntryList& list);
+    // takes over p's corrupted and extracted entries and all of its memory
+    void absorb(SoftHeap<T>& p);
+
     void sift(Node *node);
     void insert_tree(Tree *tree1, Tree *tree2);
     void remove_tree(Tree *tree);
@@ -99,6 +165,9 @@ class SoftHeap {
     void concatenate(Node *one, Node *two);
     Node *combine(Node *one, Node *two);
     void repeated_combine(size_t k);
+    // merges a root list of increasing rank, with its suffix mins set, into
+    // ours and combines what the merge leaves of equal rank
+    void merge_list(Tree *list, size_t listRank);
 
     static void merge_into(SoftHeap<T>& p, SoftHeap<T>& q);
 
@@ -131,11 +200,7 @@ SoftHeap<T>::EntryList::EntryList(Entry *entry) : head(entry), tail(entry), size
 
 template <typename T>
 SoftHeap<T>::EntryList::~EntryList() {
-  while (head) {
-    Entry *next = head->next;
-    delete head;
-    head = next;
-  }
+  // the entries belong to the heap's pool
 }
 
 // concatenates the list 'other' to the end of this list
@@ -156,71 +221,156 @@ void SoftHeap<T>::EntryList::concatenate(EntryList *other) {
 template <typename T>
 void SoftHeap<T>::EntryList::add(Entry *entry) {
   entry->next = head;
-  if (!head) {
-    head = tail = entry;
+  head = entry;
+  if (!tail) {
+    tail = entry;
   }
   size += 1;
 }
 
 template <typename T>
-SoftHeap<T>::Node::Node(const double key, const T& value) : 
-  ckey(key), rank(0), size(1), left(NULL), right(NULL), 
-  entryList(new EntryList(new Entry(key, value))), ckeyEntry(NULL) {
-    ckeyEntry = entryList->head;
+SoftHeap<T>::Node::Node(Entry *entry) : 
+  ckey(entry->mKey), ckeyEntry(entry), rank(0), size(1), left(NULL),
+  right(NULL), entryList(entry) {
+    // handled in initializer list
   }
 
 template <typename T>
-SoftHeap<T>::Node::Node() : ckey(0), rank(0), size(1), left(NULL), right(NULL),
-  entryList(new EntryList()), ckeyEntry(NULL) {
+SoftHeap<T>::Node::Node() : ckey(0), ckeyEntry(NULL), rank(0), size(1),
+  left(NULL), right(NULL) {
     // handled in initializer list    
   }
 
 template <typename T>
 SoftHeap<T>::Node::~Node() {
-  if (entryList) {
-    delete entryList;
-  }
-  if (left) {
-    delete left;
-  }
-  if (right) {
-    delete right;
-  }
+  // the children and entries belong to the heap's pools
 }
 
 template <typename T>
-SoftHeap<T>::Tree::Tree(const double key, const T& value): next(NULL), 
-  prev(NULL), suffixMin(this), rank(0), root(new Node(key, value)) {
+SoftHeap<T>::Tree::Tree(Node *node): root(node), next(NULL), 
+  prev(NULL), suffixMin(this), rank(0) {
     // handled in initializer list
   }
 
 template <typename T>
 SoftHeap<T>::Tree::~Tree() { 
-  if (root) {
-    delete root; 
-  }
-  if (next) {
-    delete next;
-  }
+  // the nodes and the other trees belong to the heap's pools
 }
 
 template <typename T>
 SoftHeap<T>::SoftHeap(const double key, const T& value, const size_t r) : 
-  heapRank(0), first(new Tree(key, value)), mR(r), mSize(1), 
-  corrupted(new EntryList()) {
-  // handled in initializer list
+  mR(r), mSize(1), mInserts(1), mSifts(0), mCorruptedInHeap(0), heapRank(0),
+  first(NULL) {
+  // the pools are only ready once the initializer list is done
+  first = new_tree(key, value);
 }
 
 template <typename T>
 SoftHeap<T>::SoftHeap() : 
-  heapRank(0), first(NULL), mR(0), mSize(0), corrupted(new EntryList()) {
+  mR(0), mSize(0), mInserts(0), mSifts(0), mCorruptedInHeap(0), heapRank(0),
+  first(NULL) {
+  // handled in initializer list
+}
+
+template <typename T>
+SoftHeap<T>::SoftHeap(const double epsilon) :
+  mR(rForEpsilon(epsilon)), mSize(0), mInserts(0), mSifts(0),
+  mCorruptedInHeap(0), heapRank(0), first(NULL) {
   // handled in initializer list
 }
 
+template <typename T>
+inline size_t SoftHeap<T>::rForEpsilon(const double epsilon) {
+  assert(epsilon > 0 && epsilon < 1);
+  return (size_t) std::ceil(std::log2(1.0 / epsilon)) + 5;
+}
+
 template <typename T>
 SoftHeap<T>::~SoftHeap() {
-  delete corrupted;
-  delete first;
+  destroy_entries();
+}
+
+template <typename T>
+void SoftHeap<T>::clear() {
+  destroy_entries();
+  entryPool.reset();
+  nodePool.reset();
+  treePool.reset();
+  corrupted = EntryList();
+  returned = EntryList();
+  first = NULL;
+  mSize = 0;
+  heapRank = 0;
+  mInserts = 0;
+  mSifts = 0;
+  mCorruptedInHeap = 0;
+}
+
+template <typename T>
+inline typename SoftHeap<T>::Node *SoftHeap<T>::new_leaf(const double key,
+    const T& value) {
+  Entry *entry = new (entryPool.allocate()) Entry(key, value);
+  return new (nodePool.allocate()) Node(entry);
+}
+
+template <typename T>
+inline typename SoftHeap<T>::Tree *SoftHeap<T>::new_tree(const double key,
+    const T& value) {
+  return new (treePool.allocate()) Tree(new_leaf(key, value));
+}
+
+template <typename T>
+inline void SoftHeap<T>::free_node(Node *node) {
+  node->~Node();
+  nodePool.deallocate(node);
+}
+
+template <typename T>
+inline void SoftHeap<T>::free_tree(Tree *tree) {
+  tree->~Tree();
+  treePool.deallocate(tree);
+}
+
+// every entry is in the list of some node, or corrupted, or returned;
+// nodes and trees hold nothing that needs destroying
+template <typename T>
+void SoftHeap<T>::destroy_entries() {
+  if (std::is_trivially_destructible<T>::value) return;
+  std::vector<Node *> stack;
+  for (Tree *tree = first; tree; tree = tree->next) {
+    stack.push_back(tree->root);
+    while (!stack.empty()) {
+      Node *node = stack.back();
+      stack.pop_back();
+      destroy_entries(node->entryList);
+      if (node->left) stack.push_back(node->left);
+      if (node->right) stack.push_back(node->right);
+    }
+  }
+  destroy_entries(corrupted);
+  destroy_entries(returned);
+}
+
+template <typename T>
+void SoftHeap<T>::destroy_entries(EntryList& list) {
+  for (Entry *entry = list.head; entry;) {
+    Entry *next = entry->next;
+    entry->~Entry();
+    entry = next;
+  }
+}
+
+template <typename T>
+void SoftHeap<T>::absorb(SoftHeap<T>& p) {
+  corrupted.concatenate(&p.corrupted);
+  returned.concatenate(&p.returned);
+  mInserts += p.mInserts;
+  mSifts += p.mSifts;
+  mCorruptedInHeap += p.mCorruptedInHeap;
+  p.mInserts = p.mSifts = p.mCorruptedInHeap = 0;
+  entryPool.absorb(p.entryPool);
+  nodePool.absorb(p.nodePool);
+  treePool.absorb(p.treePool);
 }
 
 template <typename T>
@@ -254,15 +404,97 @@ inline bool SoftHeap<T>::isEmpty() const { return mSize == 0; }
 
 template <typename T>
 inline typename SoftHeap<T>::EntryList *SoftHeap<T>::getCorrupted() {
-  return corrupted;
+  return &corrupted;
+}
+
+template <typename T>
+inline double SoftHeap<T>::getMinCkey() const {
+  assert(first);
+  return first->suffixMin->root->ckey;
+}
+
+template <typename T>
+inline size_t SoftHeap<T>::getInserts() const { return mInserts; }
+
+template <typename T>
+inline size_t SoftHeap<T>::getSifts() const { return mSifts; }
+
+template <typename T>
+inline size_t SoftHeap<T>::getCorruptions() const { return corrupted.size; }
+
+template <typename T>
+inline size_t SoftHeap<T>::getCorruptedInHeap() const {
+  return mCorruptedInHeap;
+}
+
+template <typename T>
+inline double SoftHeap<T>::getCorruptionRatio() const {
+  return mInserts ? (double) mCorruptedInHeap / mInserts : 0;
 }
 
 // inserts an element with the specified key and value into the heap
 template <typename T>
 void SoftHeap<T>::insert(const double key, const T& value) {
-  // create a new heap of size 1 and merge it into the existing heap
-  SoftHeap<T> newHeap(key, value, mR);
-  meld(newHeap);
+  // melding in a heap of size 1 would put its rank 0 tree in front of all
+  // of ours and combine from there, so do just that without the heap
+  Tree *tree = new_tree(key, value);
+  mSize++;
+  mInserts++;
+  if (!first) {
+    first = tree;
+    heapRank = 0;
+    return;
+  }
+  insert_tree(tree, first);
+  repeated_combine(0);
+}
+
+template <typename T>
+template <typename Iterator>
+void SoftHeap<T>::build(Iterator begin, Iterator end) {
+  assert(isEmpty());
+  insertBatch(begin, end);
+}
+
+// combines the leaves as a binary counter does its carries: a stack of
+// nodes of decreasing rank, where each new leaf is combined with the top
+// for as long as their ranks match. Every node is built right after its
+// two halves, while they are still in cache, and what is left on the stack
+// is one tree per set bit of the batch size.
+template <typename T>
+template <typename Iterator>
+void SoftHeap<T>::insertBatch(Iterator begin, Iterator end) {
+  batchNodes.clear();
+  size_t count = 0;
+  for (Iterator it = begin; it != end; ++it, ++count) {
+    Node *node = new_leaf(it->first, it->second);
+    while (!batchNodes.empty() && batchNodes.back()->rank == node->rank) {
+      node = combine(batchNodes.back(), node);
+      batchNodes.pop_back();
+    }
+    batchNodes.push_back(node);
+  }
+  if (count == 0) return;
+  mSize += count;
+  mInserts += count;
+
+  // the top of the stack has the lowest rank and goes first
+  Tree *list = NULL;
+  Tree *last = NULL;
+  while (!batchNodes.empty()) {
+    Tree *tree = new (treePool.allocate()) Tree(batchNodes.back());
+    tree->rank = tree->root->rank;
+    batchNodes.pop_back();
+    tree->prev = last;
+    if (last) {
+      last->next = tree;
+    } else {
+      list = tree;
+    }
+    last = tree;
+  }
+  update_suffix_min(last);
+  merge_list(list, last->rank);
 }
 
 // helper function used for debugging the root list
@@ -296,6 +528,20 @@ void SoftHeap<T>::countTrees() {
 template <typename T>
 void SoftHeap<T>::meld(SoftHeap& p) {
 
+  // melding with an empty heap only needs to move the trees over, if any
+  if (p.isEmpty() || isEmpty()) {
+    if (isEmpty() && !p.isEmpty()) {
+      first = p.getFirst();
+      mSize = p.getSize();
+      heapRank = p.getRank();
+      p.setFirst(NULL);
+      p.setSize(0);
+      p.setRank(0);
+    }
+    absorb(p);
+    return;
+  }
+
   SoftHeap<T> *resultHeap = this;
   SoftHeap<T> *otherHeap = &p;
   // merge the heap with lesser rank into the heap with greater rank 
@@ -306,13 +552,14 @@ void SoftHeap<T>::meld(SoftHeap& p) {
     
   // merge the root list of q into the root list of p, 
   // then combine trees as necessary
+  size_t otherRank = otherHeap->getRank();
   resultHeap->setSize(otherHeap->getSize() + resultHeap->getSize());
   merge_into(*otherHeap, *resultHeap);
   otherHeap->setFirst(NULL);
   otherHeap->setSize(0);
   otherHeap->setRank(0);
   // combine the trees in the root list of p
-  resultHeap->repeated_combine(otherHeap->getRank());
+  resultHeap->repeated_combine(otherRank);
 
   // if our result heap was p, transfer its members to us
   if (resultHeap != this) {
@@ -325,7 +572,8 @@ void SoftHeap<T>::meld(SoftHeap& p) {
     resultHeap->setRank(0);
   }
 
-  corrupted->concatenate(p.getCorrupted());
+  // only now, since combining in p allocates from p's pools
+  absorb(p);
 }
 
 // Extracts the min element from our heap.
@@ -340,18 +588,22 @@ typename SoftHeap<T>::Entry* SoftHeap<T>::extract_min() {
   Node *x = tree->root;
   // select an arbitrary element from this node
   Entry *entry = pick_element(x);
-  if (x->entryList->size <= x->size/2) {
+  if (x->entryList.size <= x->size/2) {
     // if our element list in the root node is too small, and the node isn't a leaf,
     // sift to replenish the list
     if (!is_leaf(x)) {
       sift(x);
       update_suffix_min(tree);
-    } else if (x->entryList->size == 0) { 
-      // if the node is a leaf and is empty, remove it
-      delete x;
+    } else if (x->entryList.size == 0) { 
+      // if the node is a leaf and is empty, remove it, and repoint the
+      // suffix mins of the trees before it, which may have pointed at it
+      Tree *prev = tree->prev;
+      free_node(x);
       remove_tree(tree);
+      if (prev) update_suffix_min(prev);
     }
   }
+  returned.add(entry);
   return entry;
 }
 
@@ -381,14 +633,10 @@ void SoftHeap<T>::insert_tree(Tree *tree1, Tree *tree2) {
 template <typename T>
 void SoftHeap<T>::remove_tree(Tree *tree) {
 
-  // if the tree we're removing had the highest rank in the heap, 
-  // decrease the rank of the heap
-  if (tree->rank == heapRank) {
-    if (tree->prev && tree->prev->rank < tree->rank && !tree->next) {
-      heapRank = tree->prev->rank;
-    } else if (!tree->next && !tree->prev) {
-      heapRank = 0;
-    }
+  // if the tree we're removing was the last one, it had the highest rank
+  // in the heap, so the rank drops to that of the tree before it
+  if (!tree->next) {
+    heapRank = tree->prev ? tree->prev->rank : 0;
   }
 
   //remove the tree from the list
@@ -401,11 +649,7 @@ void SoftHeap<T>::remove_tree(Tree *tree) {
     tree->next->prev = tree->prev;
   } 
 
-  // clean up our tree, make sure it doesn't recursively clean up others
-  tree->next = NULL;
-  tree->prev = NULL;
-  tree->root = NULL;
-  delete tree;
+  free_tree(tree);
 }
 
 // updates the suffix min pointers of our the specified tree 
@@ -431,6 +675,41 @@ void SoftHeap<T>::update_suffix_min(Tree *tree) {
   }
 }
 
+template <typename T>
+void SoftHeap<T>::merge_list(Tree *list, size_t listRank) {
+  if (!first) {
+    first = list;
+    heapRank = listRank;
+    return;
+  }
+
+  // the usual merge of two sorted lists, the new trees going first among
+  // equal ranks as in merge_into
+  size_t k = std::min(heapRank, listRank);
+  Tree *ours = first;
+  Tree *last = NULL;
+  while (list || ours) {
+    Tree *tree;
+    if (!ours || (list && list->rank <= ours->rank)) {
+      tree = list;
+      list = list->next;
+    } else {
+      tree = ours;
+      ours = ours->next;
+    }
+    tree->prev = last;
+    if (last) {
+      last->next = tree;
+    } else {
+      first = tree;
+    }
+    last = tree;
+  }
+  last->next = NULL;
+  heapRank = std::max(heapRank, listRank);
+  repeated_combine(k);
+}
+
 // merges the tree list of p into that of q
 template <typename T>
 void SoftHeap<T>::merge_into(SoftHeap<T>& p, SoftHeap<T>& q) {
@@ -465,25 +744,25 @@ void SoftHeap<T>::merge_into(SoftHeap<T>& p, SoftHeap<T>& q) {
 // choose an arbitrary element from the element list of the given node,
 // in this case the first one
 // if this entry was the original entry in the list, and therefore is pointed
-// to by our ckeyEntry pointer, we know that it is uncorrupted, and should be 
-// added to the returned set for later cleanup
+// to by our ckeyEntry pointer, we know that it is uncorrupted
 template <typename T>
 typename SoftHeap<T>::Entry* SoftHeap<T>::pick_element(Node *node) {
-  assert(node->entryList->size > 0);
+  assert(node->entryList.size > 0);
   // take the first entry off the list
-  Entry *entry = node->entryList->head;
+  Entry *entry = node->entryList.head;
   // update the list to remove the entry
-  if (node->entryList->head == node->entryList->tail) {
-    node->entryList->head = node->entryList->tail = NULL;
+  if (node->entryList.head == node->entryList.tail) {
+    node->entryList.head = node->entryList.tail = NULL;
   } else {
-    node->entryList->head = node->entryList->head->next;
+    node->entryList.head = node->entryList.head->next;
   }
-  node->entryList->size -= 1;
+  node->entryList.size -= 1;
   // if this entry was never corrupted, and therefore corresponds to our ckey,
-  // add it to the 'returned' list for cleanup, since it was never added to the
-  // 'corrupted' list
+  // the node no longer holds an entry with key ckey
   if (entry == node->ckeyEntry) {
     node->ckeyEntry = NULL;
+  } else {
+    mCorruptedInHeap--;
   }
   // make sure we can't access any other entries through this one
   return entry;
@@ -495,7 +774,7 @@ template <typename T>
 typename SoftHeap<T>::Node *SoftHeap<T>::combine(Node *node1, Node *node2) {
   assert(node1->rank == node2->rank);
   // create a new empty node
-  Node *newNode = new Node();
+  Node *newNode = new (nodePool.allocate()) Node();
   // set our arg nodes as its children
   newNode->left = node1;
   newNode->right = node2;
@@ -515,7 +794,7 @@ typename SoftHeap<T>::Node *SoftHeap<T>::combine(Node *node1, Node *node2) {
 // concatenates the entry list of node two onto the end of node one's entry list
 template <typename T>
 void SoftHeap<T>::concatenate(Node *one, Node *two) {
-  one->entryList->concatenate(two->entryList);
+  one->entryList.concatenate(&two->entryList);
 }
 
 // sifts entries upward in the tree until the specified node has reached
@@ -523,10 +802,10 @@ void SoftHeap<T>::concatenate(Node *one, Node *two) {
 template <typename T>
 void SoftHeap<T>::sift(Node *node) {
   assert(node);
-  assert(node->entryList);
+  mSifts++;
   // while our node has not yet acheived its target size and is not a leaf node,
   // sift entries up to it
-  while (node->entryList->size < node->size && !is_leaf(node)) {
+  while (node->entryList.size < node->size && !is_leaf(node)) {
     // if we don't have a left child, or our left child has the greater ckey of the
     // children, switch the children to maintain our heap ordering invariant
     if (!node->left || (node->right && node->left->ckey > node->right->ckey)) {
@@ -543,7 +822,9 @@ void SoftHeap<T>::sift(Node *node) {
     // an entry may only be corrupted once, and it happens when this node takes on a 
     // child's ckey
     if (node->ckeyEntry) {
-      corrupted->add(new Entry(node->ckeyEntry->mKey, node->ckeyEntry->mValue));
+      corrupted.add(new (entryPool.allocate())
+                    Entry(node->ckeyEntry->mKey, node->ckeyEntry->mValue));
+      mCorruptedInHeap++;
     }
     // update our pointer to the entry with key ckey
     node->ckeyEntry = node->left->ckeyEntry;
@@ -554,7 +835,7 @@ void SoftHeap<T>::sift(Node *node) {
     // if the left child is a leaf, remove it because it is now empty
     // otherwise, sift to fill the left child's entry list
     if (is_leaf(node->left)) {
-      delete node->left;
+      free_node(node->left);
       node->left = NULL;
     } else {
       sift(node->left);
@@ -575,22 +856,24 @@ void SoftHeap<T>::repeated_combine(size_t k) {
     if (tree->rank == tree->next->rank) {
       // if 3 trees have the same rank, combine the last two
       if (!tree->next->next || tree->rank != tree->next->next->rank) {
-        // combine the trees, update the rank of the new tree, and remove the old one
+        // combine the trees, update the rank of the new tree, and remove the
+        // old one; the combined tree may now match the rank of its next
+        // tree, so look at it again before moving on
         tree->root = combine(tree->root, tree->next->root);
         tree->rank = tree->root->rank;
         remove_tree(tree->next);
+        continue;
       }
     } else if (tree->rank > k) {
       break;
     }
-    // update the heap rank if our last tree had greater rank than the heap
-    if (tree->rank > heapRank) {
-      heapRank = tree->rank;
-    }
     // move on to the next tree
-    if (!tree->next) break;
     tree = tree->next;
   }
+  // update the heap rank if our last tree had greater rank than the heap
+  if (tree->rank > heapRank) {
+    heapRank = tree->rank;
+  }
 
   // update the suffix min for every tree before the last one
   update_suffix_min(tree);
@@ -0,0 +1,118 @@
+/*
+ * Times the two soft heap engines, SoftHeap and SimplifiedSoftHeap,
+ * head to head at several error rates epsilon, each with r from its own
+ * rForEpsilon:
+ *
+ *  - heap: n inserts and then extract_min until the heap is empty, with the
+ *    largest corruption ratio seen along the way,
+ *  - mst: Chazelle::mst on a random connected graph of n vertices and
+ *    density m/n, with each engine as its Heap policy,
+ *
+ * and names the faster engine for each epsilon.
+ *
+ * usage: SoftHeapBench [elements] [density]
+ */
+
+#include "CSRGraph.hh"
+#include "Chazelle.hh"
+#include "SoftHeap.hh"
+#include "SimplifiedSoftHeap.hh"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// best of three runs, so a stray page fault doesn't pick the winner
+template <typename Heap>
+static double timeHeap(const std::vector<double>& keys, double epsilon,
+                       double& ratio) {
+  double best = 0;
+  for (int run = 0; run < 3; run++) {
+    auto start = std::chrono::steady_clock::now();
+    Heap heap(epsilon);
+    ratio = 0;
+    for (size_t i = 0; i < keys.size(); ++i) heap.insert(keys[i], i);
+    while (!heap.isEmpty()) {
+      if (heap.getCorruptionRatio() > ratio) {
+        ratio = heap.getCorruptionRatio();
+      }
+      heap.extract_min();
+    }
+    double time = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    if (run == 0 || time < best) best = time;
+  }
+  return best;
+}
+
+template <typename Heap>
+static double timeChazelle(size_t n, const std::vector<CSRGraph::Edge>& edges,
+                           double epsilon, double& weight) {
+  double best = 0;
+  for (int run = 0; run < 3; run++) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<CSRGraph::Edge> tree =
+      Chazelle<uint32_t, Heap>::mst(n, edges, epsilon);
+    double time = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    if (run == 0 || time < best) best = time;
+    weight = 0;
+    for (const CSRGraph::Edge& edge : tree) weight += edge.weight;
+  }
+  return best;
+}
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 1000000;
+  size_t density = argc > 2 ? std::strtoull(argv[2], NULL, 10) : 8;
+
+  std::mt19937_64 rng(1);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::vector<double> keys(n);
+  for (size_t i = 0; i < n; i++) keys[i] = uniform(rng);
+  std::vector<CSRGraph::Edge> edges;
+  edges.reserve(density * n);
+  for (size_t i = 1; i < n; i++) {
+    CSRGraph::Edge edge = { (uint32_t) (rng() % i), (uint32_t) i,
+      uniform(rng) };
+    edges.push_back(edge);
+  }
+  while (edges.size() < density * n) {
+    CSRGraph::Edge edge = { (uint32_t) (rng() % n), (uint32_t) (rng() % n),
+      uniform(rng) };
+    edges.push_back(edge);
+  }
+
+  const char *names[] = { "soft", "simplified" };
+  std::cout << "elements " << n << ", m/n " << density << std::endl;
+  std::cout << "epsilon  heap: soft(s) ratio   simp(s) ratio   "
+            << "mst: soft(s) simp(s) fastest" << std::endl;
+  double epsilons[] = { 0.5, 0.25, 0.125, 0.0625, 0.01 };
+  for (double epsilon : epsilons) {
+    double ratios[2];
+    double heapTimes[2] = {
+      timeHeap<SoftHeap<size_t> >(keys, epsilon, ratios[0]),
+      timeHeap<SimplifiedSoftHeap<size_t> >(keys, epsilon, ratios[1])
+    };
+    double weights[2];
+    double mstTimes[2] = {
+      timeChazelle<SoftHeap<size_t> >(n, edges, epsilon, weights[0]),
+      timeChazelle<SimplifiedSoftHeap<size_t> >(n, edges, epsilon,
+                                                weights[1])
+    };
+    // the two trees add the same weights in a different order
+    if (std::abs(weights[0] - weights[1]) > 1e-6) {
+      std::cout << "tree weights differ" << std::endl;
+      return 1;
+    }
+    size_t fastest = mstTimes[1] < mstTimes[0] ? 1 : 0;
+    std::cout << epsilon << "      " << heapTimes[0] << "  " << ratios[0]
+              << "  " << heapTimes[1] << "  " << ratios[1] << "  "
+              << mstTimes[0] << "  " << mstTimes[1] << "  "
+              << names[fastest] << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,253 @@
+/*
+ * Soft Heap Partition
+ *
+ * What Chazelle and PettieRamachandran share. Both recurse on edges tagged
+ * with the position of the input edge they came from, order them by weight
+ * and then by that origin so ties break the same way at every level, and
+ * finish small levels with Kruskal. Both also split a level into subgraphs
+ * by growing each one Prim-style out of a soft heap, which is what grow
+ * does for one subgraph:
+ *
+ *  - it adds vertices from source along the lightest good edge out of the
+ *    subgraph, until it has limit vertices or that edge reaches a vertex of
+ *    an earlier subgraph, which it returns so the caller can fuse the two
+ *    or leave them apart;
+ *  - an edge is good if the heap hands it out under its own key and no
+ *    earlier growth saw it corrupted. Every edge a heap reported corrupted
+ *    is marked BAD, and the edges grown along GROWN, the one reaching an
+ *    earlier subgraph included.
+ *
+ * One heap serves every subgraph, cleared in between to reuse its slabs.
+ * Heap is the soft heap policy, with the interface of SoftHeap<size_t>:
+ * rForEpsilon, setR, clear, insertBatch, isEmpty, getMinCkey, extract_min
+ * and getCorrupted. SimplifiedSoftHeap<size_t> is the other engine;
+ * SoftHeapBench times the two against each other.
+ */
+
+#ifndef SoftHeapPartition_Included
+#define SoftHeapPartition_Included
+
+#include "CSRGraph.hh"
+#include "FlatDisjointSet.hh"
+#include "FlatDisjointSetForest.hh"
+#include "SoftHeap.hh"
+#include "SimplifiedSoftHeap.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+template <typename Heap>
+class SoftHeapPartition {
+  public:
+    typedef FlatDisjointSetForest::Edge Edge;
+
+    // what the growth learned about an edge
+    enum EdgeState { UNSEEN, GROWN, BAD };
+
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    // keeps a reference to edges, which has to outlive the partition and
+    // must not contain self loops; r is the soft heap's
+    SoftHeapPartition(size_t numVertices, const std::vector<Edge>& edges,
+                      size_t r);
+    ~SoftHeapPartition();
+
+    // grows the next subgraph from source, which must not be in one yet;
+    // returns the vertex of an earlier subgraph the growth reached, or NONE
+    uint32_t grow(uint32_t source, size_t limit);
+
+    inline size_t numSubgraphs() const;
+    // the subgraph of each vertex, NONE until one is grown over it
+    inline const std::vector<uint32_t>& getSubgraphs() const;
+    // the EdgeState of each edge
+    inline const std::vector<uint8_t>& getStates() const;
+
+    // the input edges with their positions as origins, and back
+    static std::vector<Edge> tag(const std::vector<CSRGraph::Edge>& edges);
+    static std::vector<CSRGraph::Edge> untag(
+        const std::vector<CSRGraph::Edge>& edges,
+        const std::vector<Edge>& forest);
+    // contractions and recursions report their edges with endpoints from
+    // deeper down; this appends the copies in level of deeper's edges to
+    // result, found by origin through position, scratch indexed by origin
+    static void lookUp(const std::vector<Edge>& level,
+                       const std::vector<Edge>& deeper,
+                       std::vector<Edge>& result,
+                       std::vector<size_t>& position);
+
+    static inline bool lighter(const Edge& one, const Edge& two);
+    // appends the minimum spanning forest of edges to result
+    static void kruskal(size_t numVertices, std::vector<Edge> edges,
+                        std::vector<Edge>& result);
+
+  private:
+    const std::vector<Edge>& mEdges;
+    // incident edges of every vertex in CSR form
+    std::vector<size_t> mOffsets;
+    std::vector<size_t> mIncident;
+    std::vector<uint32_t> mSubgraphs;
+    std::vector<uint8_t> mStates;
+    size_t mNumSubgraphs;
+    Heap mHeap;
+    std::vector<std::pair<double, size_t> > mOutgoing;
+
+    SoftHeapPartition(SoftHeapPartition const &) = delete;
+    void operator=(SoftHeapPartition const &) = delete;
+};
+
+template <typename Heap>
+SoftHeapPartition<Heap>::SoftHeapPartition(size_t numVertices,
+    const std::vector<Edge>& edges, size_t r) : mEdges(edges),
+  mOffsets(numVertices + 1, 0), mSubgraphs(numVertices, NONE),
+  mStates(edges.size(), UNSEEN), mNumSubgraphs(0) {
+  for (const Edge& edge : edges) {
+    mOffsets[edge.first + 1]++;
+    mOffsets[edge.second + 1]++;
+  }
+  for (size_t v = 0; v < numVertices; ++v) mOffsets[v + 1] += mOffsets[v];
+  mIncident.resize(mOffsets[numVertices]);
+  std::vector<size_t> cursor(mOffsets.begin(), mOffsets.end() - 1);
+  for (size_t i = 0; i < edges.size(); ++i) {
+    mIncident[cursor[edges[i].first]++] = i;
+    mIncident[cursor[edges[i].second]++] = i;
+  }
+  mHeap.setR(r);
+}
+
+template <typename Heap>
+SoftHeapPartition<Heap>::~SoftHeapPartition() {
+  // Does nothing.
+}
+
+template <typename Heap>
+uint32_t SoftHeapPartition<Heap>::grow(uint32_t source, size_t limit) {
+  assert(mSubgraphs[source] == NONE);
+  uint32_t current = mNumSubgraphs++;
+  mHeap.clear();
+
+  uint32_t reached = NONE;
+  size_t members = 0;
+  uint32_t vertex = source;
+  while (vertex != NONE) {
+    mSubgraphs[vertex] = current;
+    if (++members >= limit) break;
+    // the edges out of a new vertex go in as one batch
+    mOutgoing.clear();
+    for (size_t slot = mOffsets[vertex]; slot < mOffsets[vertex + 1];
+         ++slot) {
+      const Edge& edge = mEdges[mIncident[slot]];
+      uint32_t other = edge.first == vertex ? edge.second : edge.first;
+      if (mSubgraphs[other] != current) {
+        mOutgoing.push_back(std::make_pair(edge.weight, mIncident[slot]));
+      }
+    }
+    mHeap.insertBatch(mOutgoing.begin(), mOutgoing.end());
+
+    // pop until a good edge leaves the subgraph
+    vertex = NONE;
+    while (!mHeap.isEmpty()) {
+      double ckey = mHeap.getMinCkey();
+      typename Heap::Entry *entry = mHeap.extract_min();
+      size_t i = entry->mValue;
+      if (entry->mKey < ckey || mStates[i] == BAD) continue;
+      const Edge& edge = mEdges[i];
+      uint32_t other = mSubgraphs[edge.first] == current ?
+        edge.second : edge.first;
+      if (mSubgraphs[other] == current) continue;
+      mStates[i] = GROWN;
+      if (mSubgraphs[other] == NONE) {
+        vertex = other;
+      } else {
+        reached = other;
+      }
+      break;
+    }
+  }
+
+  // the heap can report an edge that sat under a ckey equal to its key,
+  // which may have been grown along honestly
+  typename Heap::Entry *entry = mHeap.getCorrupted()->head;
+  for (; entry; entry = entry->next) {
+    if (mStates[entry->mValue] == UNSEEN) mStates[entry->mValue] = BAD;
+  }
+  return reached;
+}
+
+template <typename Heap>
+inline size_t SoftHeapPartition<Heap>::numSubgraphs() const {
+  return mNumSubgraphs;
+}
+
+template <typename Heap>
+inline const std::vector<uint32_t>&
+SoftHeapPartition<Heap>::getSubgraphs() const {
+  return mSubgraphs;
+}
+
+template <typename Heap>
+inline const std::vector<uint8_t>& SoftHeapPartition<Heap>::getStates() const {
+  return mStates;
+}
+
+template <typename Heap>
+std::vector<typename SoftHeapPartition<Heap>::Edge>
+SoftHeapPartition<Heap>::tag(const std::vector<CSRGraph::Edge>& edges) {
+  std::vector<Edge> tagged;
+  tagged.reserve(edges.size());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    Edge edge = { edges[i].first, edges[i].second, edges[i].weight, i };
+    tagged.push_back(edge);
+  }
+  return tagged;
+}
+
+template <typename Heap>
+std::vector<CSRGraph::Edge> SoftHeapPartition<Heap>::untag(
+    const std::vector<CSRGraph::Edge>& edges,
+    const std::vector<Edge>& forest) {
+  std::vector<CSRGraph::Edge> result;
+  result.reserve(forest.size());
+  for (const Edge& edge : forest) {
+    result.push_back(edges[edge.origin]);
+  }
+  return result;
+}
+
+template <typename Heap>
+void SoftHeapPartition<Heap>::lookUp(const std::vector<Edge>& level,
+                                     const std::vector<Edge>& deeper,
+                                     std::vector<Edge>& result,
+                                     std::vector<size_t>& position) {
+  for (size_t i = 0; i < level.size(); ++i) {
+    position[level[i].origin] = i;
+  }
+  for (const Edge& edge : deeper) {
+    result.push_back(level[position[edge.origin]]);
+  }
+}
+
+template <typename Heap>
+inline bool SoftHeapPartition<Heap>::lighter(const Edge& one,
+                                             const Edge& two) {
+  return one.weight < two.weight ||
+    (one.weight == two.weight && one.origin < two.origin);
+}
+
+template <typename Heap>
+void SoftHeapPartition<Heap>::kruskal(size_t numVertices,
+                                      std::vector<Edge> edges,
+                                      std::vector<Edge>& result) {
+  std::sort(edges.begin(), edges.end(), lighter);
+  FlatDisjointSet sets(numVertices);
+  for (const Edge& edge : edges) {
+    if (sets.sameSet(edge.first, edge.second)) continue;
+    sets.unionSets(edge.first, edge.second);
+    result.push_back(edge);
+  }
+}
+
+#endif
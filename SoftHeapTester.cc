@@ -0,0 +1,255 @@
+#include "SoftHeap.hh"
+#include "SimplifiedSoftHeap.hh"
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// empties heap, whose element i has key keys[i], checking that every one
+// comes out once, under a ckey that never decreases and never below its
+// key, and that the corrupted ones were reported
+template <typename Heap>
+static void checkDrain(Heap& heap, const std::vector<double>& keys) {
+  assert(heap.getSize() == keys.size());
+  std::vector<bool> seen(keys.size(), false);
+  std::vector<int> corruptedOut;
+  double last = -1;
+  while (!heap.isEmpty()) {
+    double ckey = heap.getMinCkey();
+    assert(ckey >= last);
+    last = ckey;
+    typename Heap::Entry *entry = heap.extract_min();
+    assert(entry->mKey == keys[entry->mValue] && entry->mKey <= ckey);
+    assert(!seen[entry->mValue]);
+    seen[entry->mValue] = true;
+    if (entry->mKey < ckey) corruptedOut.push_back(entry->mValue);
+  }
+  std::vector<bool> corrupted(keys.size(), false);
+  typename Heap::Entry *entry = heap.getCorrupted()->head;
+  for (; entry; entry = entry->next) corrupted[entry->mValue] = true;
+  for (int value : corruptedOut) assert(corrupted[value]);
+}
+
+int main() {
+  SoftHeap<int> heap;
+  heap.setR(4);
+  assert(heap.isEmpty());
+  heap.insert(3, 3);
+  heap.insert(1, 1);
+  heap.insert(2, 2);
+  assert(heap.getSize() == 3);
+  assert(heap.getMinCkey() == 1);
+  assert(heap.extract_min()->mValue == 1);
+  assert(heap.extract_min()->mValue == 2);
+  assert(heap.extract_min()->mValue == 3);
+  assert(heap.isEmpty());
+
+  // two heaps filled by single inserts and melded
+  std::mt19937 rng(1);
+  for (size_t r = 0; r <= 12; r += 2) {
+    SoftHeap<int> soft;
+    soft.setR(r);
+    int n = 2000;
+    std::vector<double> keys(n);
+    for (int i = 0; i < n; i++) {
+      keys[i] = rng() % 1000;
+      soft.insert(keys[i], i);
+    }
+
+    SoftHeap<int> other;
+    other.setR(r);
+    for (int i = n; i < 2 * n; i++) {
+      keys.push_back(rng() % 1000);
+      other.insert(keys[i], i);
+    }
+    soft.meld(other);
+    assert(other.isEmpty());
+    assert(soft.getSize() == (size_t) (2 * n));
+    checkDrain(soft, keys);
+    // no tree reaches rank r, so no node ever held more than one element
+    if ((1 << r) > 2 * n) assert(soft.getCorrupted()->size == 0);
+  }
+
+  // values with destructors are released whether they were extracted,
+  // corrupted or still in the heap, by clear as well as the destructor; a
+  // cleared heap starts over, and melded entries live on in the result
+  SoftHeap<std::string> strings;
+  strings.setR(2);
+  for (int round = 0; round < 3; round++) {
+    strings.clear();
+    assert(strings.isEmpty() && strings.getCorrupted()->size == 0);
+    for (int i = 0; i < 500; i++) {
+      strings.insert(rng() % 100, "element number " + std::to_string(i));
+    }
+    for (int i = 0; i < 200; i++) strings.extract_min();
+    assert(strings.getSize() == 300);
+  }
+  std::vector<SoftHeap<std::string>::Entry *> extracted;
+  {
+    SoftHeap<std::string> donor;
+    donor.setR(2);
+    for (int i = 0; i < 100; i++) {
+      donor.insert(i, "donated element " + std::to_string(i));
+    }
+    for (int i = 0; i < 10; i++) extracted.push_back(donor.extract_min());
+    strings.meld(donor);
+  }
+  assert(strings.getSize() == 390);
+  for (int i = 0; i < 10; i++) {
+    assert(extracted[i]->mValue ==
+           "donated element " + std::to_string((int) extracted[i]->mKey));
+  }
+
+  // r from epsilon keeps the corrupted elements in the heap below epsilon
+  // times the inserts all along, and the counters add up through meld
+  for (double epsilon : { 0.5, 0.125, 0.01 }) {
+    SoftHeap<int> heap(epsilon);
+    assert(heap.getR() == SoftHeap<int>::rForEpsilon(epsilon));
+    SoftHeap<int> other(epsilon);
+    for (int i = 0; i < 20000; i++) {
+      heap.insert(rng() % 5000, i);
+      other.insert(rng() % 5000, i);
+      assert(heap.getCorruptionRatio() <= epsilon);
+    }
+    size_t sifts = heap.getSifts() + other.getSifts();
+    size_t corrupted = heap.getCorruptedInHeap() + other.getCorruptedInHeap();
+    heap.meld(other);
+    assert(heap.getInserts() == 40000 && other.getInserts() == 0);
+    // combining the two root lists sifts and may corrupt some more
+    assert(heap.getSifts() >= sifts && heap.getCorruptedInHeap() >= corrupted);
+    for (int i = 0; !heap.isEmpty(); i++) {
+      heap.extract_min();
+      if (i % 2 == 0 && i < 20000) heap.insert(rng() % 5000, i);
+      assert(heap.getCorruptionRatio() <= epsilon);
+    }
+    assert(heap.getInserts() == 50000);
+    assert(heap.getCorruptedInHeap() == 0);
+    assert(heap.getCorruptions() == heap.getCorrupted()->size);
+    heap.clear();
+    assert(heap.getInserts() == 0 && heap.getSifts() == 0);
+    assert(heap.getCorruptions() == 0 && heap.getCorruptionRatio() == 0);
+  }
+
+  // heaps built in one go, or fed in batches of every size between single
+  // inserts, keep the same guarantees
+  for (size_t r = 0; r <= 8; r += 4) {
+    std::vector<double> keys;
+    std::vector<std::pair<double, int> > batch;
+    for (int i = 0; i < 3000; i++) {
+      keys.push_back(rng() % 1000);
+      batch.push_back(std::make_pair(keys[i], i));
+    }
+    SoftHeap<int> built;
+    built.setR(r);
+    built.build(batch.begin(), batch.end());
+    assert(built.getInserts() == 3000);
+    checkDrain(built, keys);
+
+    SoftHeap<int> fed;
+    fed.setR(r);
+    size_t next = 0;
+    for (size_t size = 0; next < batch.size(); size++) {
+      size_t end = std::min(batch.size(), next + size * size % 97);
+      fed.insertBatch(batch.begin() + next, batch.begin() + end);
+      next = end;
+      if (next < batch.size() && size % 3 == 0) {
+        fed.insert(batch[next].first, batch[next].second);
+        next++;
+      }
+      assert(fed.getSize() == next);
+    }
+    checkDrain(fed, keys);
+  }
+
+  // the simplified soft heap keeps the same guarantees through single
+  // inserts, batches and meld, r from epsilon included
+  for (double epsilon : { 0.5, 0.125, 0.01 }) {
+    SimplifiedSoftHeap<int> simple(epsilon);
+    assert(simple.getR() == SimplifiedSoftHeap<int>::rForEpsilon(epsilon));
+    SimplifiedSoftHeap<int> other(epsilon);
+    std::vector<double> keys;
+    std::vector<std::pair<double, int> > batch;
+    for (int i = 0; i < 20000; i++) {
+      keys.push_back(rng() % 5000);
+      if (i % 3 == 0) {
+        simple.insert(keys[i], i);
+      } else if (i % 3 == 1) {
+        other.insert(keys[i], i);
+      } else {
+        batch.push_back(std::make_pair(keys[i], i));
+      }
+      assert(simple.getCorruptionRatio() <= epsilon);
+      assert(other.getCorruptionRatio() <= epsilon);
+    }
+    simple.insertBatch(batch.begin(), batch.end());
+    simple.meld(other);
+    assert(other.isEmpty() && other.getInserts() == 0);
+    assert(simple.getSize() == 20000 && simple.getInserts() == 20000);
+    assert(simple.getCorruptionRatio() <= epsilon);
+    for (int i = 0; i < 5000; i++) {
+      simple.extract_min();
+      assert(simple.getCorruptionRatio() <= epsilon);
+    }
+    simple.clear();
+    assert(simple.isEmpty() && simple.getCorruptions() == 0);
+
+    // the cleared heap built again from the batch alone, renumbered
+    keys.clear();
+    for (size_t i = 0; i < batch.size(); ++i) {
+      batch[i].second = i;
+      keys.push_back(batch[i].first);
+    }
+    simple.build(batch.begin(), batch.end());
+    checkDrain(simple, keys);
+    assert(simple.getCorruptedInHeap() == 0);
+  }
+  for (size_t r = 0; r <= 12; r += 3) {
+    SimplifiedSoftHeap<int> simple;
+    simple.setR(r);
+    SimplifiedSoftHeap<int> other;
+    other.setR(r);
+    std::vector<double> keys;
+    for (int i = 0; i < 4000; i++) {
+      keys.push_back(rng() % 1000);
+      if (i % 2) {
+        simple.insert(keys[i], i);
+      } else {
+        other.insert(keys[i], i);
+      }
+    }
+    simple.meld(other);
+    checkDrain(simple, keys);
+    if ((1 << r) > 4000) assert(simple.getCorrupted()->size == 0);
+  }
+
+  SimplifiedSoftHeap<std::string> simpleStrings;
+  simpleStrings.setR(2);
+  for (int round = 0; round < 3; round++) {
+    simpleStrings.clear();
+    for (int i = 0; i < 500; i++) {
+      simpleStrings.insert(rng() % 100, "element number " + std::to_string(i));
+    }
+    for (int i = 0; i < 200; i++) simpleStrings.extract_min();
+    assert(simpleStrings.getSize() == 300);
+  }
+  std::vector<SimplifiedSoftHeap<std::string>::Entry *> simpleExtracted;
+  {
+    SimplifiedSoftHeap<std::string> donor;
+    donor.setR(2);
+    for (int i = 0; i < 100; i++) {
+      donor.insert(i, "donated element " + std::to_string(i));
+    }
+    for (int i = 0; i < 10; i++) simpleExtracted.push_back(donor.extract_min());
+    simpleStrings.meld(donor);
+  }
+  assert(simpleStrings.getSize() == 390);
+  for (int i = 0; i < 10; i++) {
+    assert(simpleExtracted[i]->mValue ==
+           "donated element " + std::to_string((int) simpleExtracted[i]->mKey));
+  }
+
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * Spanning Forest
+ *
+ * Minimum spanning forests of graphs with any number of components, by
+ * solving each component on its own. Prim only grows the tree of vertex 0,
+ * so this
+ *
+ *  1. unions the endpoints of every edge in a ConcurrentDisjointSet, the
+ *     edges split between the threads,
+ *  2. numbers the components and gives every vertex a local id inside its
+ *     component, and buckets the edges by component in those ids (a
+ *     counting sort, self-loops dropped),
+ *  3. hands the components of two or more vertices, largest first, to
+ *     Parallel::forEach, where each thread takes the next one as soon as it
+ *     is done, so many small components don't wait behind a big one.
+ *
+ * A component of n vertices and n - 1 edges is already its own tree and is
+ * copied; the others go through Prim with the Queue policy. Component c's
+ * tree is written to its own slots of the result, so the threads never
+ * share anything but the task counter.
+ */
+
+#ifndef SpanningForest_Included
+#define SpanningForest_Included
+
+#include "UndirectedGraph.hh"
+#include "CSRGraph.hh"
+#include "InternedGraph.hh"
+#include "ConcurrentDisjointSet.hh"
+#include "Parallel.hh"
+#include "Prim.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+template <typename T, typename Queue = IndexedFibonacciHeap>
+class SpanningForest {
+  public:
+    // numThreads of 0 uses every hardware thread
+    static UndirectedGraph<T> mst(const UndirectedGraph<T>& graph,
+                                  size_t numThreads = 0);
+    static std::vector<CSRGraph::Edge> mst(const CSRGraph& graph,
+                                           size_t numThreads = 0);
+    // the forest has one tree per component, numVertices minus the number
+    // of components edges in all
+    static std::vector<CSRGraph::Edge> mst(size_t numVertices,
+        const std::vector<CSRGraph::Edge>& edges, size_t numThreads = 0);
+};
+
+template <typename T, typename Queue>
+UndirectedGraph<T> SpanningForest<T, Queue>::mst(
+    const UndirectedGraph<T>& graph, size_t numThreads) {
+  InternedGraph<T> interned(graph);
+  return interned.translate(mst(interned.getGraph(), numThreads));
+}
+
+template <typename T, typename Queue>
+std::vector<CSRGraph::Edge> SpanningForest<T, Queue>::mst(
+    const CSRGraph& graph, size_t numThreads) {
+  return mst(graph.size(), graph.edgeList(), numThreads);
+}
+
+template <typename T, typename Queue>
+std::vector<CSRGraph::Edge> SpanningForest<T, Queue>::mst(size_t numVertices,
+    const std::vector<CSRGraph::Edge>& edges, size_t numThreads) {
+  numThreads = Parallel::numThreads(numThreads);
+  const uint32_t NONE = UINT32_MAX;
+
+  ConcurrentDisjointSet sets(numVertices);
+  Parallel::forChunks(edges.size(), numThreads,
+    [&](size_t begin, size_t end, size_t) {
+      for (size_t i = begin; i < end; ++i) {
+        sets.unionSets(edges[i].first, edges[i].second);
+      }
+    });
+  std::vector<uint32_t> root(numVertices);
+  Parallel::forChunks(numVertices, numThreads,
+    [&](size_t begin, size_t end, size_t) {
+      for (size_t v = begin; v < end; ++v) root[v] = sets.find(v);
+    });
+
+  // components are numbered in order of their lowest vertex, and local ids
+  // in order of the global ones
+  std::vector<uint32_t> component(numVertices, NONE);
+  std::vector<uint32_t> local(numVertices);
+  std::vector<uint32_t> vertexOffsets(1, 0);
+  for (size_t v = 0; v < numVertices; ++v) {
+    if (component[root[v]] == NONE) {
+      component[root[v]] = vertexOffsets.size() - 1;
+      vertexOffsets.push_back(0);
+    }
+    uint32_t c = component[root[v]];
+    local[v] = vertexOffsets[c + 1]++;
+  }
+  size_t numComponents = vertexOffsets.size() - 1;
+  for (size_t c = 0; c < numComponents; ++c) {
+    vertexOffsets[c + 1] += vertexOffsets[c];
+  }
+  std::vector<uint32_t> vertices(numVertices);
+  for (size_t v = 0; v < numVertices; ++v) {
+    uint32_t c = component[root[v]];
+    vertices[vertexOffsets[c] + local[v]] = v;
+  }
+
+  std::vector<size_t> edgeOffsets(numComponents + 1, 0);
+  for (const CSRGraph::Edge& edge : edges) {
+    if (edge.first == edge.second) continue;
+    edgeOffsets[component[root[edge.first]] + 1]++;
+  }
+  for (size_t c = 0; c < numComponents; ++c) {
+    edgeOffsets[c + 1] += edgeOffsets[c];
+  }
+  std::vector<CSRGraph::Edge> localEdges(edgeOffsets[numComponents]);
+  std::vector<size_t> fill(edgeOffsets.begin(), edgeOffsets.end() - 1);
+  for (const CSRGraph::Edge& edge : edges) {
+    if (edge.first == edge.second) continue;
+    CSRGraph::Edge localEdge = { local[edge.first], local[edge.second],
+      edge.weight };
+    localEdges[fill[component[root[edge.first]]]++] = localEdge;
+  }
+
+  std::vector<uint32_t> tasks;
+  for (size_t c = 0; c < numComponents; ++c) {
+    if (vertexOffsets[c + 1] - vertexOffsets[c] > 1) tasks.push_back(c);
+  }
+  std::sort(tasks.begin(), tasks.end(), [&](uint32_t one, uint32_t two) {
+    return edgeOffsets[one + 1] - edgeOffsets[one] >
+      edgeOffsets[two + 1] - edgeOffsets[two];
+  });
+
+  // component c's tree goes to the n_c - 1 slots from vertexOffsets[c] - c
+  std::vector<CSRGraph::Edge> result(numVertices - numComponents);
+  Parallel::forEach(tasks.size(), numThreads, [&](size_t task, size_t) {
+    uint32_t c = tasks[task];
+    size_t size = vertexOffsets[c + 1] - vertexOffsets[c];
+    const uint32_t *ids = &vertices[vertexOffsets[c]];
+    CSRGraph::Edge *out = &result[vertexOffsets[c] - c];
+    std::vector<CSRGraph::Edge> part(localEdges.begin() + edgeOffsets[c],
+                                     localEdges.begin() + edgeOffsets[c + 1]);
+    if (part.size() != size - 1) {
+      part = Prim<T, Queue>::mst(CSRGraph(size, part));
+    }
+    for (size_t i = 0; i < part.size(); ++i) {
+      CSRGraph::Edge edge = { ids[part[i].first], ids[part[i].second],
+        part[i].weight };
+      out[i] = edge;
+    }
+  });
+  return result;
+}
+
+#endif
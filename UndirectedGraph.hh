@@ -1,3 +1,9 @@
+#ifndef UndirectedGraph_Included
+#define UndirectedGraph_Included
+
+#include <cstddef>
+#include <unordered_map>
+
 template <typename T>
 class UndirectedGraph {
 public:
@@ -8,16 +14,18 @@ public:
 	inline bool isEmpty() const;
 	inline bool containsNode(const T& value) const;
 
-	inline void edgeCost(const T& first, const T& second) const;
-	inline const std::unordered_map<const T&, double>& edgesFrom(const T& value)
+	inline double edgeCost(const T& first, const T& second) const;
+	inline const std::unordered_map<T, double>& edgesFrom(const T& value)
 			const;
 
 	void addNode(const T& value); // can consider making this return a bool
 	void addEdge(const T& first, const T& second, double weight);
 	void removeEdge(const T& first, const T& second);
 
-	typedef std::unordered_map<const T&, double>::iterator iterator;
-	typedef std::unordered_map<const T&, double>::const_iterator const_iterator;
+	typedef typename std::unordered_map<T, std::unordered_map<T, double>>::iterator
+			iterator;
+	typedef typename std::unordered_map<T, std::unordered_map<T, double>>::const_iterator
+			const_iterator;
 
 	inline iterator begin();
 	inline iterator end();
@@ -27,7 +35,7 @@ public:
 	inline const_iterator cend() const;
 
 private:
-	std::unordered_map<const T&, std::unordered_map<const T&, double>> mGraph;
+	std::unordered_map<T, std::unordered_map<T, double>> mGraph;
 };
 
 template <typename T>
@@ -56,16 +64,16 @@ inline bool UndirectedGraph<T>::containsNode(const T& value) const {
 }
 
 template <typename T>
-inline void UndirectedGraph<T>::edgeCost(const T& first,
-																				 const T& second) const {
+inline double UndirectedGraph<T>::edgeCost(const T& first,
+																					 const T& second) const {
 	// maybe include checks?
-	return mGraph[first][second];
+	return mGraph.at(first).at(second);
 }
 
 template <typename T>
-inline const std::unordered_map<const T&, double>&
+inline const std::unordered_map<T, double>&
 UndirectedGraph<T>::edgesFrom(const T& value) const {
-	return mGraph[value];
+	return mGraph.at(value);
 }
 
 template <typename T>
@@ -87,30 +95,37 @@ void UndirectedGraph<T>::removeEdge(const T& first, const T& second) {
 }
 
 template <typename T>
-void UndirectedGraph<T>::iterator begin() {
+inline typename UndirectedGraph<T>::iterator UndirectedGraph<T>::begin() {
 	return mGraph.begin();
 }
 
 template <typename T>
-void UndirectedGraph<T>::iterator end() {
+inline typename UndirectedGraph<T>::iterator UndirectedGraph<T>::end() {
 	return mGraph.end();
 }
 
-void UndirectedGraph<T>::const_iterator begin() const {
+template <typename T>
+inline typename UndirectedGraph<T>::const_iterator
+UndirectedGraph<T>::begin() const {
 	return mGraph.begin();
 }
 
 template <typename T>
-void UndirectedGraph<T>::const_iterator end() const {
+inline typename UndirectedGraph<T>::const_iterator
+UndirectedGraph<T>::end() const {
 	return mGraph.end();
 }
 
 template <typename T>
-void UndirectedGraph<T>::iterator cbegin() {
+inline typename UndirectedGraph<T>::const_iterator
+UndirectedGraph<T>::cbegin() const {
 	return mGraph.cbegin();
 }
 
 template <typename T>
-void UndirectedGraph<T>::iterator cend() {
+inline typename UndirectedGraph<T>::const_iterator
+UndirectedGraph<T>::cend() const {
 	return mGraph.cend();
 }
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * Vertex Interner
+ *
+ * Maps arbitrary vertex keys to the dense ids [0, size()) that CSRGraph and
+ * the id-based algorithms run on, and back again. Keys are hashed once, at
+ * load time, into a flat open-addressing table with linear probing: each
+ * slot is an 8 byte (id, hash tag) pair, so a probe sequence walks a
+ * contiguous run of memory and only touches the stored key when the tags
+ * match.
+ */
+
+#ifndef VertexInterner_Included
+#define VertexInterner_Included
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+template <typename T, typename Hash = std::hash<T>>
+class VertexInterner {
+  public:
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+    VertexInterner();
+    VertexInterner(size_t expectedSize);
+    ~VertexInterner();
+
+    inline size_t size() const;
+    inline bool isEmpty() const;
+
+    // returns the id of value, assigning the next free id if it is new
+    uint32_t intern(const T& value);
+    // returns the id of value, or NOT_FOUND
+    inline uint32_t find(const T& value) const;
+    inline const T& valueOf(uint32_t id) const;
+
+    void reserve(size_t expectedSize);
+
+  private:
+    struct Slot {
+      uint32_t id;
+      uint32_t tag;
+    };
+
+    std::vector<Slot> mSlots;
+    std::vector<T> mValues;
+    size_t mMask;
+    Hash mHash;
+
+    inline uint64_t hashOf(const T& value) const;
+    void rehash(size_t capacity);
+};
+
+template <typename T, typename Hash>
+VertexInterner<T, Hash>::VertexInterner() : mMask(0) {
+  rehash(16);
+}
+
+template <typename T, typename Hash>
+VertexInterner<T, Hash>::VertexInterner(size_t expectedSize) : mMask(0) {
+  rehash(16);
+  reserve(expectedSize);
+}
+
+template <typename T, typename Hash>
+VertexInterner<T, Hash>::~VertexInterner() {
+  // Does nothing.
+}
+
+template <typename T, typename Hash>
+inline size_t VertexInterner<T, Hash>::size() const {
+  return mValues.size();
+}
+
+template <typename T, typename Hash>
+inline bool VertexInterner<T, Hash>::isEmpty() const {
+  return mValues.empty();
+}
+
+// std::hash is the identity for integers, which clusters badly under linear
+// probing with a power of two table, so scramble it with a Fibonacci multiply
+template <typename T, typename Hash>
+inline uint64_t VertexInterner<T, Hash>::hashOf(const T& value) const {
+  return (uint64_t) mHash(value) * 0x9E3779B97F4A7C15ull;
+}
+
+template <typename T, typename Hash>
+uint32_t VertexInterner<T, Hash>::intern(const T& value) {
+  // keep the load factor at or below one half
+  if (2 * (mValues.size() + 1) > mSlots.size()) {
+    rehash(2 * mSlots.size());
+  }
+
+  uint64_t hash = hashOf(value);
+  uint32_t tag = (uint32_t) hash;
+  for (size_t i = (hash >> 32) & mMask; ; i = (i + 1) & mMask) {
+    Slot& slot = mSlots[i];
+    if (slot.id == NOT_FOUND) {
+      slot.id = mValues.size();
+      slot.tag = tag;
+      mValues.push_back(value);
+      return slot.id;
+    }
+    if (slot.tag == tag && mValues[slot.id] == value) {
+      return slot.id;
+    }
+  }
+}
+
+template <typename T, typename Hash>
+inline uint32_t VertexInterner<T, Hash>::find(const T& value) const {
+  uint64_t hash = hashOf(value);
+  uint32_t tag = (uint32_t) hash;
+  for (size_t i = (hash >> 32) & mMask; ; i = (i + 1) & mMask) {
+    const Slot& slot = mSlots[i];
+    if (slot.id == NOT_FOUND) return NOT_FOUND;
+    if (slot.tag == tag && mValues[slot.id] == value) return slot.id;
+  }
+}
+
+template <typename T, typename Hash>
+inline const T& VertexInterner<T, Hash>::valueOf(uint32_t id) const {
+  return mValues[id];
+}
+
+template <typename T, typename Hash>
+void VertexInterner<T, Hash>::reserve(size_t expectedSize) {
+  size_t capacity = mSlots.size();
+  while (capacity < 2 * expectedSize) capacity *= 2;
+  if (capacity != mSlots.size()) rehash(capacity);
+  mValues.reserve(expectedSize);
+}
+
+// capacity must be a power of two
+template <typename T, typename Hash>
+void VertexInterner<T, Hash>::rehash(size_t capacity) {
+  Slot empty = { NOT_FOUND, 0 };
+  std::vector<Slot> old(capacity, empty);
+  old.swap(mSlots);
+  mMask = capacity - 1;
+
+  // reinsert by id; the tags are only a hash prefix so the position has to
+  // be recomputed from the key
+  for (const Slot& slot : old) {
+    if (slot.id == NOT_FOUND) continue;
+    uint64_t hash = hashOf(mValues[slot.id]);
+    size_t i = (hash >> 32) & mMask;
+    while (mSlots[i].id != NOT_FOUND) i = (i + 1) & mMask;
+    mSlots[i] = slot;
+  }
+}
+
+#endif